@@ -0,0 +1,124 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#include "AnalysisThread.hpp"
+
+AnalysisThread::AnalysisThread() : Thread("Zircon Analysis") {
+    for(int stream = 0; stream < max_streams; stream++) {
+        trackers.add(new pitch_alloc::Mpm<float>(frame_size));
+    }
+    
+    block.resize(frame_size, 0.0f);
+}
+
+AnalysisThread::~AnalysisThread() {
+    stopThread(1000);
+}
+
+void AnalysisThread::set_enabled(bool enabled) {
+    if(enabled && !isThreadRunning()) {
+        startThread();
+    }
+    else if(!enabled && isThreadRunning()) {
+        stopThread(1000);
+    }
+}
+
+AnalysisThread::Frame* AnalysisThread::get_free_frame() {
+    int start_1, size_1, start_2, size_2;
+    frame_fifo.prepareToWrite(1, start_1, size_1, start_2, size_2);
+    
+    return size_1 > 0 ? &frames[start_1] : nullptr;
+}
+
+void AnalysisThread::push() {
+    frame_fifo.finishedWrite(1);
+}
+
+bool AnalysisThread::pop(Result& result) {
+    int start_1, size_1, start_2, size_2;
+    result_fifo.prepareToRead(1, start_1, size_1, start_2, size_2);
+    
+    if(size_1 == 0) return false;
+    
+    result = results[start_1];
+    result_fifo.finishedRead(1);
+    return true;
+}
+
+void AnalysisThread::run() {
+    while(!threadShouldExit()) {
+        int start_1, size_1, start_2, size_2;
+        frame_fifo.prepareToRead(1, start_1, size_1, start_2, size_2);
+        
+        if(size_1 == 0) {
+            wait(poll_ms);
+            continue;
+        }
+        
+        analyse(frames[start_1], scratch);
+        frame_fifo.finishedRead(1);
+        
+        // When the audio thread doesn't collect, the result is dropped: it's late by then anyway
+        result_fifo.prepareToWrite(1, start_1, size_1, start_2, size_2);
+        if(size_1 > 0) {
+            results[start_1] = scratch;
+            result_fifo.finishedWrite(1);
+        }
+    }
+}
+
+void AnalysisThread::analyse(const Frame& frame, Result& result) {
+    result.stream = frame.stream;
+    result.hop = frame.hop;
+    result.generation = frame.generation;
+    
+    auto& tracker = *trackers[std::clamp(frame.stream, 0, max_streams - 1)];
+    
+    for(int n = 0; n < frame_size; n++) block[n] = frame.signal[n] / frame.amplitude[n];
+    
+    float pitch = tracker.probabilistic_pitch(block, sample_rate);
+    
+    result.pitch = std::isfinite(pitch) && pitch != -1 ? pitch : 0.0f;
+    result.confidence = tracker.confidence;
+    
+    // Hann windowed Goertzel filter at each band centre
+    result.num_bands = std::min(frame.num_bands, max_bands);
+    
+    for(int band = 0; band < result.num_bands; band++) {
+        float frequency = std::pow(2.0f, (frame.first_note + band * frame.band_step - 69.0f) / 12.0f) * 440.0f;
+        float coefficient = 2.0f * std::cos(MathConstants<float>::twoPi * frequency / sample_rate);
+        
+        float s1 = 0.0f, s2 = 0.0f;
+        for(int n = 0; n < frame_size; n++) {
+            float s0 = frame.signal[n] * window[n] + coefficient * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+        
+        // A sine at the centre with amplitude A gives |X| = A * frame_size / 4 through the window, so this is A^2 / 2
+        float magnitude = s1 * s1 + s2 * s2 - coefficient * s1 * s2;
+        result.band_energies[band] = 8.0f * magnitude / ((float)frame_size * frame_size);
+    }
+}
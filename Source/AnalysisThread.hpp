@@ -0,0 +1,114 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include "PitchDetection/pitch_detection.h"
+#include "WindowCache.hpp"
+
+#include <JuceHeader.h>
+
+// Pitch, pitch confidence and chroma band energies, computed away from the audio thread
+//
+// The audio thread hands over a frame per hop through a lock-free ring and picks up the results from another one,
+// neither side ever waits for the other. The thread polls its ring every poll_ms instead of being woken up,
+// because signalling an event from the audio thread takes a lock.
+// Results come back whenever they're ready, how long to wait for them is up to the caller.
+class AnalysisThread : private Thread
+{
+public:
+    
+    static constexpr int frame_size = 2048;
+    static constexpr int max_streams = 2;
+    static constexpr int max_bands = 128;
+    static constexpr int poll_ms = 2;
+    
+    // Frames and results in flight, the audio thread only needs a few hops worth
+    static constexpr int capacity = 8;
+    
+    struct Frame
+    {
+        // Each stream has its own pitch tracker, hop and generation tell the results apart
+        int stream = 0;
+        int64 hop = 0;
+        int generation = 0;
+        
+        // The block to track, and the envelope that normalises it
+        std::array<float, frame_size> signal {};
+        std::array<float, frame_size> amplitude {};
+        
+        // Band centres are every band_step MIDI notes from first_note on
+        int first_note = 0;
+        int band_step = 1;
+        int num_bands = 0;
+    };
+    
+    struct Result
+    {
+        int stream = 0;
+        int64 hop = -1;
+        int generation = 0;
+        
+        // Hz, 0 when there is no pitch
+        float pitch = 0.0f;
+        float confidence = 0.0f;
+        
+        // Mean square of the signal around each band centre
+        std::array<float, max_bands> band_energies {};
+        int num_bands = 0;
+    };
+    
+    AnalysisThread();
+    ~AnalysisThread() override;
+    
+    // Starts or stops the thread, call from the message thread
+    void set_enabled(bool enabled);
+    bool is_enabled() const { return isThreadRunning(); }
+    
+    // Audio thread: a frame to fill in and push(), or nullptr when the ring is full
+    Frame* get_free_frame();
+    void push();
+    
+    // Audio thread: takes the oldest result, returns false when there is none
+    bool pop(Result& result);
+    
+private:
+    
+    void run() override;
+    
+    void analyse(const Frame& frame, Result& result);
+    
+    std::array<Frame, capacity> frames;
+    std::array<Result, capacity> results;
+    AbstractFifo frame_fifo { capacity };
+    AbstractFifo result_fifo { capacity };
+    
+    // Only touched by the analysis thread
+    OwnedArray<pitch_alloc::Mpm<float>> trackers;
+    std::vector<float> block;
+    const std::vector<float>& window = WindowCache::get(WindowCache::hann, frame_size);
+    Result scratch;
+    
+    static constexpr float sample_rate = 44100.0f;
+};
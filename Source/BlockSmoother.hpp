@@ -0,0 +1,154 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include <JuceHeader.h>
+
+// Parameter smoother that renders a whole block at once
+// Once the target is reached, process() stops writing and is_constant() tells the caller to apply a single gain
+// One rendered ramp is meant to be shared by everything that reads it in the same block, like all bands of a distortion
+template<typename SmoothingType = ValueSmoothingTypes::Linear>
+class BlockSmoother
+{
+public:
+    
+    void prepare(double sample_rate, double ramp_length_seconds, int max_block_size) {
+        ramp_length = (int)std::floor(ramp_length_seconds * sample_rate);
+        ramp.resize(max_block_size);
+        set_current_and_target(target);
+    }
+    
+    void set_target(float new_target) {
+        if(new_target == target) return;
+        
+        if(ramp_length <= 0) {
+            set_current_and_target(new_target);
+            return;
+        }
+        
+        target = new_target;
+        countdown = ramp_length;
+        
+        if constexpr(std::is_same_v<SmoothingType, ValueSmoothingTypes::Linear>) {
+            step = (target - current) / (float)countdown;
+        }
+        else {
+            // Multiplicative ramps can't cross or touch zero
+            jassert(current != 0.0f && target != 0.0f && (current > 0.0f) == (target > 0.0f));
+            step = std::exp((std::log(std::abs(target)) - std::log(std::abs(current))) / (float)countdown);
+        }
+    }
+    
+    void set_current_and_target(float new_value) {
+        target = current = new_value;
+        countdown = 0;
+    }
+    
+    float get_target() const { return target; }
+    float get_current() const { return current; }
+    
+    bool is_smoothing() const { return countdown > 0; }
+    
+    // Advances by num_samples, only writes the ramp buffer when the value is still moving
+    void process(int num_samples) {
+        jassert(num_samples <= (int)ramp.size());
+        
+        constant = countdown == 0;
+        if(constant) return;
+        
+        int ramp_samples = std::min(countdown, num_samples);
+        float* data = ramp.data();
+        
+        // No loop-carried dependency, so these vectorise
+        if constexpr(std::is_same_v<SmoothingType, ValueSmoothingTypes::Linear>) {
+            for(int n = 0; n < ramp_samples; n++) data[n] = current + step * (float)(n + 1);
+        }
+        else {
+            float log_step = std::log(step);
+            for(int n = 0; n < ramp_samples; n++) data[n] = current * std::exp(log_step * (float)(n + 1));
+        }
+        
+        countdown -= ramp_samples;
+        
+        // Snap to the target at the end so rounding errors don't pile up
+        if(countdown == 0) {
+            current = target;
+            FloatVectorOperations::fill(data + ramp_samples, target, num_samples - ramp_samples);
+        }
+        else {
+            current = data[ramp_samples - 1];
+        }
+    }
+    
+    // Advances by num_samples without rendering, for blocks nobody reads
+    void skip(int num_samples) {
+        int skipped = std::min(countdown, num_samples);
+        if(skipped == 0) return;
+        
+        countdown -= skipped;
+        
+        if(countdown == 0) {
+            current = target;
+        }
+        else if constexpr(std::is_same_v<SmoothingType, ValueSmoothingTypes::Linear>) {
+            current += step * (float)skipped;
+        }
+        else {
+            current *= std::pow(step, (float)skipped);
+        }
+    }
+    
+    // Values of the last processed block, only valid when is_constant() is false
+    const float* get_ramp() const { return ramp.data(); }
+    bool is_constant() const { return constant; }
+    
+    // Value at sample n of the last processed block
+    float get(int n) const { return constant ? current : ramp[n]; }
+    
+    // Multiply by the last processed block, in place or while copying
+    void apply(float* data, int num_samples) const {
+        if(constant) FloatVectorOperations::multiply(data, current, num_samples);
+        else         FloatVectorOperations::multiply(data, ramp.data(), num_samples);
+    }
+    
+    void apply(float* destination, const float* source, int num_samples) const {
+        if(constant) FloatVectorOperations::multiply(destination, source, current, num_samples);
+        else         FloatVectorOperations::multiply(destination, source, ramp.data(), num_samples);
+    }
+    
+    // Add the last processed block to data
+    void add_to(float* data, int num_samples) const {
+        if(constant) FloatVectorOperations::add(data, current, num_samples);
+        else         FloatVectorOperations::add(data, ramp.data(), num_samples);
+    }
+    
+private:
+    
+    float current = 0.0f, target = 0.0f, step = 0.0f;
+    int countdown = 0, ramp_length = 0;
+    bool constant = true;
+    
+    std::vector<float> ramp;
+};
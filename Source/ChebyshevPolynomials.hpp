@@ -0,0 +1,318 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Waveshaper tables for the Chebyshev distortion, shared by all instances in a process
+// The generators are constexpr, so a compiler with a large enough constexpr budget puts the finished tables in read-only memory.
+// Xcode and VS2019 raise that budget in Zircon.jucer. Other compilers (clang at its default -fconstexpr-steps)
+// stop evaluating and fill the tables once at static-init time instead, which keeps the build working without extra flags
+//
+// Both kinds have a fixed parity per order, so only x in [0, 1] is stored:
+//   first kind:  sin((x + 1) * pi * n) = (-1)^n * sin(n * pi * x), always odd
+//   second kind: T_n(x) + offset_n, where the offset moves f(0) to zero. Only even orders have an offset, so the parity is (-1)^n
+//
+// Define ZIRCON_CHEBYSHEV_TABLES=0 to leave all tables out,
+// the shaper then evaluates the polynomials on the fly with Clenshaw's recurrence.
+// That costs more CPU per sample, but it's worth it for hosts running hundreds of instances
+
+#ifndef ZIRCON_CHEBYSHEV_TABLES
+#define ZIRCON_CHEBYSHEV_TABLES 1
+#endif
+
+namespace ChebyshevPolynomials
+{
+
+// The order is clamped to 20 and the shaper mixes in order + 1
+inline constexpr int num_polynomials = 22;
+
+// Points over [0, 1], the same resolution as 2048 points over [-1, 1]
+inline constexpr int table_size = 1024;
+
+inline constexpr double pi = 3.14159265358979323846;
+
+// One row per table point, holding every order at that point
+// A fractional order mixes two neighbouring orders, so both values are read from the same row
+using Row = std::array<float, num_polynomials>;
+
+struct TableSet
+{
+    std::array<Row, table_size + 1> values {};
+
+    // Factor for negative inputs (the parity), and the DC offset added afterwards
+    std::array<float, num_polynomials> mirror {};
+    std::array<float, num_polynomials> offsets {};
+};
+
+// First and second antiderivatives of the second kind, both zero at x = 0
+// Double precision: ADAA divides differences of these, which cancels a lot of precision
+struct AntiderivativeSet
+{
+    std::array<std::array<double, table_size + 1>, num_polynomials> first {};
+    std::array<std::array<double, table_size + 1>, num_polynomials> second {};
+};
+
+constexpr double offset(int order) {
+    if(order == 0) return 0.0;
+    return ((order - 1) & 1) - (((order & 3) == 0) * 2);
+}
+
+// Taylor series, only valid for |t| <= pi / 2
+constexpr double sin_taylor(double t) {
+    double term = t, sum = t;
+    for(int k = 1; k < 12; k++) {
+        term *= -t * t / ((2.0 * k) * (2.0 * k + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cos_taylor(double t) {
+    double term = 1.0, sum = 1.0;
+    for(int k = 1; k < 12; k++) {
+        term *= -t * t / ((2.0 * k - 1.0) * (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// sin(pi * x) and cos(pi * x) for x in [0, 1]
+constexpr double sin_pi(double x) { return x <= 0.5 ? sin_taylor(pi * x) : sin_taylor(pi * (1.0 - x)); }
+constexpr double cos_pi(double x) { return x <= 0.5 ? cos_taylor(pi * x) : -cos_taylor(pi * (1.0 - x)); }
+
+// T_k(x) for all orders, plus the integrals of T_k from the closed form:
+//   int T_n = (T_n+1 / (n + 1) - T_n-1 / (n - 1)) / 2 for n >= 2
+// and the same recursion once more for the second integral
+struct Integrals
+{
+    std::array<double, num_polynomials + 2> polynomial {};
+    std::array<double, num_polynomials + 1> first {};
+    std::array<double, num_polynomials> second {};
+};
+
+constexpr Integrals integrate(double x) {
+    Integrals result {};
+
+    result.polynomial[0] = 1.0;
+    result.polynomial[1] = x;
+    for(int k = 2; k < num_polynomials + 2; k++) {
+        result.polynomial[k] = 2.0 * x * result.polynomial[k - 1] - result.polynomial[k - 2];
+    }
+
+    result.first[0] = x;
+    result.first[1] = 0.5 * x * x;
+    for(int k = 2; k < num_polynomials + 1; k++) {
+        result.first[k] = 0.5 * (result.polynomial[k + 1] / (k + 1) - result.polynomial[k - 1] / (k - 1));
+    }
+
+    result.second[0] = 0.5 * x * x;
+    result.second[1] = x * x * x / 6.0;
+    for(int k = 2; k < num_polynomials; k++) {
+        result.second[k] = 0.5 * (result.first[k + 1] / (k + 1) - result.first[k - 1] / (k - 1));
+    }
+
+    return result;
+}
+
+inline const Integrals integrals_at_zero = integrate(0.0);
+
+// Antiderivatives of T_n(x) + offset_n, shifted so they're zero at x = 0
+constexpr double first_antiderivative(const Integrals& integrals, int order, double x) {
+    if(order == 0) return 0.0;
+    return integrals.first[order] - integrals_at_zero.first[order] + offset(order) * x;
+}
+
+constexpr double second_antiderivative(const Integrals& integrals, int order, double x) {
+    if(order == 0) return 0.0;
+    return integrals.second[order] - integrals_at_zero.second[order] - integrals_at_zero.first[order] * x + offset(order) * x * x * 0.5;
+}
+
+constexpr TableSet make_first_kind() {
+    TableSet result {};
+
+    for(int i = 0; i <= table_size; i++) {
+        double x = (double)i / table_size;
+        double cosine = cos_pi(x);
+
+        // sin(n * theta) = 2 * cos(theta) * sin((n - 1) * theta) - sin((n - 2) * theta)
+        double previous = 0.0, current = sin_pi(x);
+        for(int n = 1; n < num_polynomials; n++) {
+            result.values[i][n] = (n & 1) ? -current : current;
+
+            double next = 2.0 * cosine * current - previous;
+            previous = current;
+            current = next;
+        }
+    }
+
+    for(int n = 0; n < num_polynomials; n++) {
+        result.mirror[n] = -1.0f;
+        result.offsets[n] = 0.0f;
+    }
+
+    return result;
+}
+
+constexpr TableSet make_second_kind() {
+    TableSet result {};
+
+    for(int i = 0; i <= table_size; i++) {
+        double x = (double)i / table_size;
+
+        double previous = 1.0, current = x;
+        for(int n = 1; n < num_polynomials; n++) {
+            result.values[i][n] = current;
+
+            double next = 2.0 * x * current - previous;
+            previous = current;
+            current = next;
+        }
+    }
+
+    // 0th order polynomial is silence
+    for(int n = 1; n < num_polynomials; n++) {
+        result.mirror[n] = (n & 1) ? -1.0f : 1.0f;
+        result.offsets[n] = offset(n);
+    }
+
+    return result;
+}
+
+constexpr AntiderivativeSet make_antiderivatives() {
+    AntiderivativeSet result {};
+
+    for(int i = 0; i <= table_size; i++) {
+        double x = (double)i / table_size;
+        auto integrals = integrate(x);
+
+        for(int n = 0; n < num_polynomials; n++) {
+            result.first[n][i] = first_antiderivative(integrals, n, x);
+            result.second[n][i] = second_antiderivative(integrals, n, x);
+        }
+    }
+
+    return result;
+}
+
+#if ZIRCON_CHEBYSHEV_TABLES
+// Deliberately const instead of constexpr: constant initialisation when the compiler can evaluate them, dynamic otherwise
+inline const TableSet first_kind = make_first_kind();
+inline const TableSet second_kind = make_second_kind();
+inline const AntiderivativeSet antiderivatives = make_antiderivatives();
+#endif
+
+// Linear interpolation on the stored half of an antiderivative table, magnitude is clamped to [0, 1]
+template<typename Type>
+inline Type interpolate(const std::array<Type, table_size + 1>& table, Type magnitude) {
+    Type position = std::min<Type>(magnitude, 1) * table_size;
+    int index = std::min((int)position, table_size - 1);
+    Type frac = position - (Type)index;
+
+    return table[index] + frac * (table[index + 1] - table[index]);
+}
+
+// Row and fraction for linear interpolation between two rows, magnitude is clamped to [0, 1]
+inline int get_row(float magnitude, float& frac) {
+    float position = std::min(magnitude, 1.0f) * table_size;
+    int index = std::min((int)position, table_size - 1);
+    frac = position - (float)index;
+    return index;
+}
+
+inline float lookup(const TableSet& tables, int order, float x) {
+    float frac;
+    int index = get_row(std::abs(x), frac);
+
+    float y = tables.values[index][order] + frac * (tables.values[index + 1][order] - tables.values[index][order]);
+    return (x < 0.0f ? y * tables.mirror[order] : y) + tables.offsets[order];
+}
+
+// Second kind and its antiderivatives at any x in [-1, 1], for ADAA
+// Read from the tables when they're compiled in, otherwise evaluated in closed form
+inline double evaluate_second_kind(int order, double x) {
+    if(order == 0) return 0.0;
+#if ZIRCON_CHEBYSHEV_TABLES
+    return lookup(second_kind, order, x);
+#else
+    return integrate(x).polynomial[order] + offset(order);
+#endif
+}
+
+inline double evaluate_first_antiderivative(int order, double x) {
+#if ZIRCON_CHEBYSHEV_TABLES
+    // f has parity (-1)^n, so its antiderivative has the opposite parity
+    double y = interpolate(antiderivatives.first[order], std::abs(x));
+    return x < 0.0 && !(order & 1) ? -y : y;
+#else
+    return first_antiderivative(integrate(x), order, x);
+#endif
+}
+
+inline double evaluate_second_antiderivative(int order, double x) {
+#if ZIRCON_CHEBYSHEV_TABLES
+    double y = interpolate(antiderivatives.second[order], std::abs(x));
+    return x < 0.0 && (order & 1) ? -y : y;
+#else
+    return second_antiderivative(integrate(x), order, x);
+#endif
+}
+
+// Below this difference the divided differences are ill-conditioned, the midpoint is used instead
+inline constexpr double adaa_epsilon = 1e-5;
+
+// First order antiderivative anti-aliasing of the second kind, for input x0 after x1
+// Delays by half a sample
+inline double evaluate_first_order_adaa(int order, double x0, double x1) {
+    double dx = x0 - x1;
+    if(std::abs(dx) < adaa_epsilon) return evaluate_second_kind(order, 0.5 * (x0 + x1));
+
+    return (evaluate_first_antiderivative(order, x0) - evaluate_first_antiderivative(order, x1)) / dx;
+}
+
+// Second order antiderivative anti-aliasing of the second kind, for input x0 after x1 and x2
+// Delays by a whole sample
+inline double evaluate_second_order_adaa(int order, double x0, double x1, double x2) {
+    auto divided_difference = [order](double a, double b) {
+        if(std::abs(a - b) < adaa_epsilon) return evaluate_first_antiderivative(order, 0.5 * (a + b));
+        return (evaluate_second_antiderivative(order, a) - evaluate_second_antiderivative(order, b)) / (a - b);
+    };
+
+    double dx = x0 - x2;
+    if(std::abs(dx) >= adaa_epsilon) {
+        return 2.0 * (divided_difference(x0, x1) - divided_difference(x1, x2)) / dx;
+    }
+
+    // x0 and x2 are (nearly) the same, expand around their mean
+    double mean = 0.5 * (x0 + x2);
+    double delta = mean - x1;
+    if(std::abs(delta) < adaa_epsilon) return evaluate_second_kind(order, 0.5 * (mean + x1));
+
+    return (2.0 / delta) * (evaluate_first_antiderivative(order, mean) + (evaluate_second_antiderivative(order, x1) - evaluate_second_antiderivative(order, mean)) / delta);
+}
+
+}
@@ -1,311 +1,398 @@
-/**********************************************************************
-*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
-*                      Utrecht, the Netherlands
-*                          All rights reserved
-***********************************************************************
-*  This program is free software: you can redistribute it and/or modify
-*  it under the terms of the GNU General Public License as published by
-*  the Free Software Foundation, either version 3 of the License, or
-*  (at your option) any later version.
-*
-*  This program is distributed in the hope that it will be useful,
-*  but WITHOUT ANY WARRANTY; without even the implied warranty of
-*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-*  GNU General Public License for more details.
-*
-*  You should have received a copy of the GNU General Public License
-*  along with this program.
-*  If not, see <http://www.gnu.org/licenses/>.
-***********************************************************************
-*
-*  Author             : Timothy Schoen
-*  E-mail             : timschoen123@gmail.com
-*
-**********************************************************************/
-#include "ChebyshevTable.hpp"
-
-
-
-bool ChebyshevFactory::fill_tables() {
-    
-    for(int i = 0; i < num_polynomials; i++) {
-        int order = i;
-        
-        first_tables[i].initialise([order](float x) mutable {
-            
-            return sinf((x + 1.0) * M_PI * order);
-            /*
-            if(x == 0.0f) return 0.0f;
-            if(order == 0) return 0.0f;
-                        
-            float offset = (order - 1 & 1) - (((order & 3) == 0) * 2);
-            float y = cos(acos(x) * order) + offset;
-            
-            jassert(std::isfinite(y));
-            
-            return y; */
-            
-        }, -1.0f, 1.0f, 1<<11);
-        
-        
-        second_tables[i].initialise([order](float x) mutable {
-            if(x == 0.0f) return 0.0f;
-            if(order == 0) return 0.0f;
-                        
-            float offset = (order - 1 & 1) - (((order & 3) == 0) * 2);
-            float y = cos(acos(x) * order) + offset;
-            
-            jassert(std::isfinite(y));
-            
-            return y;
-            
-        }, -1.0f, 1.0f, 1<<11);
-    }
-    return true;
-}
-
-
-ChebyshevTable::ChebyshevTable(const ProcessSpec& spec, std::vector<float> centre_freqs) :  lfo(spec)
-{
-    process_spec = spec;
-    
-    sample_rate = spec.sampleRate;
-
-    num_channels = spec.numChannels;
-    
-    smoothed_order.reset(sample_rate, 0.02f);
-    smoothed_volume.reset(sample_rate, 0.02f);
-    smoothed_scaling.reset(sample_rate, 0.02f);
-
-    buffer = AudioBlock<float>(buffer_data, num_channels, spec.maximumBlockSize);
-    lfo_buffer = AudioBlock<float>(lfo_buffer_data, num_channels, spec.maximumBlockSize);
-    
-    smoothed_order_buffer = AudioBlock<float>(smoothed_order_data, 1, spec.maximumBlockSize);
-    smoothed_volume_buffer = AudioBlock<float>(smoothed_volume_data, 1, spec.maximumBlockSize);
-    smoothed_scaling_buffer = AudioBlock<float>(smoothed_scaling_data, num_channels, spec.maximumBlockSize);
-    temp_buffer = AudioBlock<float>(temp_data, num_channels, spec.maximumBlockSize);
-    
-    current_table = &ChebyshevFactory::first_tables;
-    
-    set_centre_freqs(centre_freqs);
-}
-
-ChebyshevTable::ChebyshevTable(const ProcessSpec& spec, const ChebyshevTable& to_copy) :  lfo(spec) {
-    
-    process_spec = spec;
-    
-    sample_rate = spec.sampleRate;
-
-    num_channels = spec.numChannels;
-    
-    smoothed_order.reset(sample_rate, 0.02f);
-    smoothed_volume.reset(sample_rate, 0.02f);
-    smoothed_scaling.reset(sample_rate, 0.02f);
-
-    buffer = AudioBlock<float>(buffer_data, num_channels, spec.maximumBlockSize);
-    lfo_buffer = AudioBlock<float>(lfo_buffer_data, num_channels, spec.maximumBlockSize);
-    
-    smoothed_order_buffer = AudioBlock<float>(smoothed_order_data, 1, spec.maximumBlockSize);
-    smoothed_volume_buffer = AudioBlock<float>(smoothed_volume_data, 1, spec.maximumBlockSize);
-    smoothed_scaling_buffer = AudioBlock<float>(smoothed_scaling_data, num_channels, spec.maximumBlockSize);
-    temp_buffer = AudioBlock<float>(temp_data, num_channels, spec.maximumBlockSize);
-    
-    enabled = to_copy.enabled;
-    kind    = to_copy.kind;
-    order   = to_copy.order;
-    volume  = to_copy.volume;
-    scaling = to_copy.scaling;
-    mod_freq   = to_copy.mod_freq;
-    mod_depth  = to_copy.mod_depth;
-    mod_shape  = to_copy.mod_shape;
-    lfo_sync   = to_copy.lfo_sync;
-    lfo_stereo = to_copy.lfo_stereo;
-    high_mode  = to_copy.high_mode;
-    filter_freqs = to_copy.filter_freqs;
-    
-    current_table = kind ? &ChebyshevFactory::second_tables : &ChebyshevFactory::first_tables;
-    
-    smoothed_order.setCurrentAndTargetValue(order);
-    smoothed_volume.setCurrentAndTargetValue(volume);
-    smoothed_scaling.setCurrentAndTargetValue(scaling);
-
-    // Make sure state is also set for all LFOs
-    lfo.set_depth(mod_depth);
-    lfo.set_frequency(mod_freq);
-    lfo.set_voice(mod_shape);
-    lfo.set_stereo(lfo_stereo);
-    lfo.set_sync(lfo_sync);
-
-    set_centre_freqs(filter_freqs);
-}
-
-
-void ChebyshevTable::process(std::vector<AudioBlock<float>>& input, std::vector<AudioBlock<float>>& output, std::vector<AudioBlock<float>>& phase) {
-    
-    int num_samples = input[0].getNumSamples();
-    
-    lfo_buffer.clear();
-    auto subblock = lfo_buffer.getSubBlock(0, num_samples);
-    lfo.process(subblock);
-
-    // Calculate smoothed parameters
-    smoothed_order_buffer.fill(1.0f);
-    smoothed_order_buffer *= smoothed_order;
-    
-    smoothed_volume_buffer.fill(1.0f);
-    smoothed_volume_buffer *= smoothed_volume;
-    
-    smoothed_scaling_buffer.fill(1.0f);
-    smoothed_scaling_buffer *= smoothed_scaling;
-    
-    auto* smoothed_order_ptr = smoothed_order_buffer.getChannelPointer(0);
-    
-    for(int b = 0; b < input.size(); b++) {
-        // Don't process the expected target region is above either nyquist or the human hearing limit!
-        if(!enabled || filter_freqs[b] * smoothed_order.getTargetValue() > std::min<float>(sample_rate / 2 - 1, 20000.0f)) {
-            continue;
-        }
-        
-        buffer.copyFrom(input[b]);
-        
-        // Get and apply scaling
-        temp_buffer.copyFrom(smoothed_scaling_buffer);
-        
-        buffer *= temp_buffer.getSubBlock(0, num_samples);
-        
-        for(int ch = 0; ch < buffer.getNumChannels(); ch++) {
-            auto channel_block = buffer.getSingleChannelBlock(ch);
-            auto* channel_ptr = buffer.getChannelPointer(ch);
-            
-            for(int n = 0; n < num_samples; n++) {
-                // Get LFO value
-                float mod_source = lfo_buffer.getSample(ch, n);
-                
-                // Calculate final polynomial order
-                float order = smoothed_order_ptr[n] + mod_source;
-                
-                // 0th order polynomial is silence so start at 1
-                order = std::clamp(order + 1.0f, 1.0f, 20.0f);
-                
-                // Find neighboring integer polynomials
-                int first_order = order;
-                int second_order = first_order + 1;
-                
-                // Calculate mix
-                float amp = order - (float)first_order;
-                
-                float phase_value = kind ? buffer.getSample(ch, n) : jmap<float>(phase[b].getSample(ch, n), -M_PI, M_PI, -1.0, 1.0);
-                
-                // Get values from wavetables and mix together
-                float y1 = (*current_table)[first_order].processSample(phase_value) * (1.0f - amp);
-                float y2 = (*current_table)[second_order].processSample(phase_value) * amp;
-                
-                channel_ptr[n] = (y1 + y2);
-                channel_ptr[n] *= invert_phase ? -1.0f : 1.0f;
-                
-                jassert(std::isfinite(channel_ptr[n]));
-            
-            }
-            // Apply smoothed polynomial volume (y-axis value)
-            channel_block *= smoothed_volume_buffer.getSubBlock(0, num_samples);
-        }
-        
-        // Noise filter:
-        // This filter is set to the expected output frequency range, which order * filter_freq
-        // Normally a bandpass filter, or a highpass filter in high mode
-        auto final_buffer = buffer.getSubBlock(0, num_samples);
-        noise_filters[b].process(ProcessContextReplacing<float>(final_buffer));
-        
-        output[b] += final_buffer;
-    }
-}
-
-
-void ChebyshevTable::set_centre_freqs(std::vector<float> centre_freqs) {
-    filter_freqs = centre_freqs;
-    
-    noise_filters.clear();
-    noise_filters.resize(centre_freqs.size());
-    
-    // Prepare filters at centre frequencies multiplied by polynomial order
-    for(int b = 0; b < filter_freqs.size(); b++) {
-        float centre_freq = std::clamp<float>(filter_freqs[b] * smoothed_order.getTargetValue(), 0, sample_rate / 2 - 1);
-        noise_filters[b].reset();
-        noise_filters[b].prepare(process_spec);
-        noise_filters[b].setType(high_mode ? StateVariableTPTFilterType::bandpass : StateVariableTPTFilterType::highpass);
-        noise_filters[b].setCutoffFrequency(high_mode ? centre_freq : (centre_freq * (2.0f / 3.0f)));
-        //noise_filters[b].setResonance(1.0f / sqrt(2));
-        noise_filters[b].setResonance(1.2f);
-    }
-}
-
-void ChebyshevTable::sync_with_playhead(AudioPlayHead* playhead) {
-    lfo.sync_with_playhead(playhead);
-}
-
-void ChebyshevTable::receive_message(const Identifier& id, float value)  {
-    
-        if(id == Identifier("X")) {
-            //bool kind = changed_tree.getProperty("Kind");
-            order = value * 8.1 + 0.12;
-            smoothed_order.setTargetValue(order);
-            
-            for(int b = 0; b < filter_freqs.size(); b++) {
-                float centre_freq = std::clamp<float>(filter_freqs[b] * smoothed_order.getTargetValue(), 0, sample_rate / 2 - 1);
-                noise_filters[b].setType(high_mode ? StateVariableTPTFilterType::bandpass : StateVariableTPTFilterType::highpass);
-                noise_filters[b].setCutoffFrequency(high_mode ? centre_freq : (centre_freq * (2.0f / 3.0f)));
-            }
-        }
-        else if(id == Identifier("Y")) {
-            float new_gain = 1.0f - value;
-            smoothed_scaling.setTargetValue(new_gain);
-            scaling = new_gain;
-        }
-        else if(id == Identifier("Kind")) {
-            kind = value;
-            current_table = kind ? &ChebyshevFactory::second_tables : &ChebyshevFactory::first_tables;
-        }
-        else if(id == Identifier("Phase")) {
-            invert_phase = value;
-        }
-        else if(id == Identifier("ModDepth")) {
-            mod_depth = value;
-            lfo.set_depth(value);
-        }
-        else if(id == Identifier("ModSettings")) {
-            bool sync = (int)value & 1;
-            lfo_sync = sync;
-            lfo.set_sync(sync);
-            
-            bool stereo = (int)value & 2;
-            lfo_stereo = stereo;
-            lfo.set_stereo(stereo);
-        }
-        else if(id == Identifier("ModShape")) {
-            mod_shape = (int)value;
-            lfo.set_voice(mod_shape);
-        }
-        else if(id == Identifier("ModRate")) {
-            mod_freq = value;
-            lfo.set_frequency(mod_freq);
-        }
-        else if(id == Identifier("Enabled")) {
-            enabled = value;
-        }
-        else if(id == Identifier("Volume")) {
-            float new_volume = value * 1.5f;
-            // Apply volume scaling
-            volume = pow((new_volume + 1.0f), 2.0f) - 1.0f;
-            smoothed_volume.setTargetValue(volume);
-        }
-        else if(id == Identifier("Disharmonic")) {
-            high_mode = !value;
-            
-            // Apply mode to filters
-            for(int b = 0; b < filter_freqs.size(); b++) {
-                float centre_freq = std::clamp<float>(filter_freqs[b] * smoothed_order.getTargetValue(), 0, sample_rate / 2 - 1);
-                noise_filters[b].setType(high_mode ? StateVariableTPTFilterType::bandpass : StateVariableTPTFilterType::highpass);
-                noise_filters[b].setCutoffFrequency(high_mode ? centre_freq : (centre_freq * (2.0f / 3.0f)));
-            }
-        }
-}
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#include "ChebyshevTable.hpp"
+#include "Kernels/Kernels.hpp"
+
+
+ChebyshevTable::ChebyshevTable(const ProcessSpec& spec, std::vector<float> centre_freqs)
+{
+    process_spec = spec;
+    
+    sample_rate = spec.sampleRate;
+
+    num_channels = spec.numChannels;
+    
+    smoothed_order.prepare(sample_rate, 0.02f, spec.maximumBlockSize);
+    smoothed_volume.prepare(sample_rate, 0.02f, spec.maximumBlockSize);
+    smoothed_scaling.prepare(sample_rate, 0.02f, spec.maximumBlockSize);
+
+    buffer = AudioBlock<float>(buffer_data, num_channels, spec.maximumBlockSize);
+
+    shaper_buffer = AudioBlock<float>(shaper_data, 2, spec.maximumBlockSize);
+    oversampled_buffer = AudioBlock<float>(oversampled_data, 3, spec.maximumBlockSize << HalfbandOversampler::max_stages);
+    
+    set_centre_freqs(centre_freqs);
+}
+
+ChebyshevTable::ChebyshevTable(const ProcessSpec& spec, const ChebyshevTable& to_copy) {
+    
+    process_spec = spec;
+    
+    sample_rate = spec.sampleRate;
+
+    num_channels = spec.numChannels;
+    
+    smoothed_order.prepare(sample_rate, 0.02f, spec.maximumBlockSize);
+    smoothed_volume.prepare(sample_rate, 0.02f, spec.maximumBlockSize);
+    smoothed_scaling.prepare(sample_rate, 0.02f, spec.maximumBlockSize);
+
+    buffer = AudioBlock<float>(buffer_data, num_channels, spec.maximumBlockSize);
+
+    shaper_buffer = AudioBlock<float>(shaper_data, 2, spec.maximumBlockSize);
+    oversampled_buffer = AudioBlock<float>(oversampled_data, 3, spec.maximumBlockSize << HalfbandOversampler::max_stages);
+    
+    enabled = to_copy.enabled;
+    kind    = to_copy.kind;
+    order   = to_copy.order;
+    volume  = to_copy.volume;
+    scaling = to_copy.scaling;
+    mod_depth  = to_copy.mod_depth;
+    adaa_order = to_copy.adaa_order;
+    high_mode  = to_copy.high_mode;
+    filter_freqs = to_copy.filter_freqs;
+    
+    oversampling_stages = to_copy.oversampling_stages;
+    oversampling_mode   = to_copy.oversampling_mode;
+    latency             = to_copy.latency;
+    
+    smoothed_order.set_current_and_target(order);
+    smoothed_volume.set_current_and_target(volume);
+    smoothed_scaling.set_current_and_target(scaling);
+
+    set_centre_freqs(filter_freqs);
+}
+
+
+void ChebyshevTable::process(std::vector<AudioBlock<float>>& input, std::vector<AudioBlock<float>>& output, std::vector<AudioBlock<float>>& phase, const AudioBlock<float>& modulation) {
+    
+    int num_samples = input[0].getNumSamples();
+
+    // Calculate smoothed parameters once, all bands and channels share them
+    smoothed_order.process(num_samples);
+    smoothed_volume.process(num_samples);
+    smoothed_scaling.process(num_samples);
+    
+    for(int b = 0; b < input.size(); b++) {
+        // Don't process the expected target region is above either nyquist or the human hearing limit!
+        float nyquist = sample_rate * (1 << oversampling_stages) / 2;
+        if(!enabled || filter_freqs[b] * smoothed_order.get_target() > std::min<float>(nyquist - 1, 20000.0f)) {
+            continue;
+        }
+        
+        // Every band gets its own factor, so the highest band doesn't set the cost for all of them
+        auto& oversampler = oversamplers[b];
+        oversampler.set_num_stages(get_num_stages(b));
+        
+        int factor = oversampler.get_factor();
+        int oversampled_samples = num_samples * factor;
+        
+        // The ADAA history holds inputs at the rate the band ran at before
+        // Restart it from the last input, so the divided differences don't see a jump
+        if(factor != band_factors[b]) {
+            band_factors[b] = factor;
+            for(auto& history : adaa_history[b]) history = {history[0], history[0]};
+        }
+        
+        for(int ch = 0; ch < buffer.getNumChannels(); ch++) {
+            auto* channel_ptr = buffer.getChannelPointer(ch);
+            
+            // Copy the band and apply scaling in one go
+            smoothed_scaling.apply(channel_ptr, input[b].getChannelPointer(ch), num_samples);
+            
+            auto* lfo_ptr = modulation.getChannelPointer(ch);
+            auto* phase_ptr = phase[b].getChannelPointer(ch);
+            
+            auto* shaper_input = kind ? channel_ptr : shaper_buffer.getChannelPointer(0);
+            auto* shaper_order = shaper_buffer.getChannelPointer(1);
+            
+            // Calculate final polynomial order from the LFO value
+            // 0th order polynomial is silence so start at 1
+            FloatVectorOperations::add(shaper_order, lfo_ptr, 1.0f, num_samples);
+            smoothed_order.add_to(shaper_order, num_samples);
+            FloatVectorOperations::clip(shaper_order, shaper_order, 1.0f, 20.0f, num_samples);
+            
+            // Map the phase from [-pi, pi] to [-1, 1]
+            if(!kind) FloatVectorOperations::multiply(shaper_input, phase_ptr, 1.0f / MathConstants<float>::pi, num_samples);
+            
+            if(factor == 1 && kind && adaa_order) {
+                process_adaa(shaper_input, shaper_order, channel_ptr, adaa_history[b][ch], num_samples);
+            }
+            else if(factor == 1) {
+                // Get values from wavetables and mix together
+                shape(shaper_input, shaper_order, channel_ptr, num_samples);
+            }
+            else {
+                auto* oversampled_input = oversampled_buffer.getChannelPointer(0);
+                auto* oversampled_order = oversampled_buffer.getChannelPointer(1);
+                
+                if(kind) {
+                    oversampler.upsample(ch, shaper_input, oversampled_input, oversampled_buffer.getChannelPointer(2), num_samples);
+                }
+                else {
+                    // The phase wraps around, so filtering it would ring at every wrap
+                    // Interpolate the unwrapped phase instead
+                    float previous = last_phase[b][ch];
+                    for(int n = 0; n < num_samples; n++) {
+                        float delta = shaper_input[n] - previous;
+                        if(delta > 1.0f) delta -= 2.0f;
+                        else if(delta < -1.0f) delta += 2.0f;
+                        
+                        for(int i = 0; i < factor; i++) {
+                            float interpolated = previous + delta * (i + 1) / factor;
+                            oversampled_input[n * factor + i] = interpolated > 1.0f ? interpolated - 2.0f : (interpolated < -1.0f ? interpolated + 2.0f : interpolated);
+                        }
+                        
+                        previous = shaper_input[n];
+                    }
+                }
+                
+                // The order is a slow control signal, holding it is good enough
+                for(int n = 0; n < num_samples; n++) {
+                    std::fill(oversampled_order + n * factor, oversampled_order + (n + 1) * factor, shaper_order[n]);
+                }
+                
+                if(kind && adaa_order) {
+                    process_adaa(oversampled_input, oversampled_order, oversampled_input, adaa_history[b][ch], oversampled_samples);
+                }
+                else {
+                    shape(oversampled_input, oversampled_order, oversampled_input, oversampled_samples);
+                }
+                
+                oversampler.downsample(ch, oversampled_input, channel_ptr, num_samples);
+            }
+            
+            if(!kind) last_phase[b][ch] = shaper_input[num_samples - 1];
+            
+            // Apply smoothed polynomial volume (y-axis value)
+            smoothed_volume.apply(channel_ptr, num_samples);
+        }
+        
+        // Noise filter:
+        // This filter is set to the expected output frequency range, which order * filter_freq
+        // Normally a bandpass filter, or a highpass filter in high mode
+        auto final_buffer = buffer.getSubBlock(0, num_samples);
+        noise_filters[b].process(ProcessContextReplacing<float>(final_buffer));
+        
+        // Line up with the oversampled bands
+        if(latency > 0) {
+            // The interpolated phase skips the upsampling filter, so it only has the downsampling half of the latency
+            float band_latency = oversampler.get_latency_in_samples() * (kind ? 1.0f : 0.5f) + get_adaa_delay(factor);
+            latency_delays[b]->setDelay(latency - roundToInt(band_latency));
+            latency_delays[b]->process(ProcessContextReplacing<float>(final_buffer));
+        }
+        
+        output[b] += final_buffer;
+    }
+}
+
+int ChebyshevTable::get_num_stages(int band) const {
+    // The highest polynomial we mix in is order + 2, the LFO can push it up further
+    float highest_harmonic = filter_freqs[band] * (smoothed_order.get_target() + mod_depth + 2.0f);
+    
+    // ADAA already suppresses most of the aliasing, so 2x is enough on top of it
+    int max_stages = kind && adaa_order ? std::min(oversampling_stages, 1) : oversampling_stages;
+    
+    // Smallest factor that keeps that harmonic below nyquist, limited by the quality setting
+    int stages = 0;
+    while(stages < max_stages && highest_harmonic > sample_rate * (1 << stages) / 2) {
+        stages++;
+    }
+    
+    return stages;
+}
+
+void ChebyshevTable::shape(const float* input, const float* orders, float* output, int num_samples) {
+    float gain = invert_phase ? -1.0f : 1.0f;
+    
+#if ZIRCON_CHEBYSHEV_TABLES
+    auto* tables = kind ? &ChebyshevPolynomials::second_kind : &ChebyshevPolynomials::first_kind;
+    Kernels::get().chebyshev_shape(input, orders, output, tables, gain, num_samples);
+#else
+    Kernels::get().chebyshev_clenshaw(input, orders, output, kind, gain, num_samples);
+#endif
+}
+
+void ChebyshevTable::process_adaa(const float* input, const float* orders, float* output, std::array<float, 2>& history, int num_samples) {
+    
+    using namespace ChebyshevPolynomials;
+    
+    double gain = invert_phase ? -1.0 : 1.0;
+    double x1 = history[0], x2 = history[1];
+    
+    for(int n = 0; n < num_samples; n++) {
+        // The antiderivatives are only valid inside the table range
+        double x0 = std::clamp<double>(input[n], -1.0, 1.0);
+        
+        // Find neighboring integer polynomials and mix them, like the regular kernel
+        int first_order = (int)orders[n];
+        double amp = orders[n] - (float)first_order;
+        
+        double y1, y2;
+        if(adaa_order == 1) {
+            y1 = evaluate_first_order_adaa(first_order, x0, x1);
+            y2 = evaluate_first_order_adaa(first_order + 1, x0, x1);
+        }
+        else {
+            y1 = evaluate_second_order_adaa(first_order, x0, x1, x2);
+            y2 = evaluate_second_order_adaa(first_order + 1, x0, x1, x2);
+        }
+        
+        output[n] = (y1 * (1.0 - amp) + y2 * amp) * gain;
+        
+        x2 = x1;
+        x1 = x0;
+    }
+    
+    history = {(float)x1, (float)x2};
+}
+
+void ChebyshevTable::reset() {
+    for(auto& filter : noise_filters) filter.reset();
+    for(auto& oversampler : oversamplers) oversampler.reset();
+    for(auto* delay : latency_delays) delay->reset();
+    
+    for(auto& band : last_phase) std::fill(band.begin(), band.end(), 0.0f);
+    for(auto& band : adaa_history) std::fill(band.begin(), band.end(), std::array<float, 2>{0.0f, 0.0f});
+    
+    smoothed_volume.set_current_and_target(smoothed_volume.get_target());
+    smoothed_scaling.set_current_and_target(smoothed_scaling.get_target());
+    smoothed_order.set_current_and_target(smoothed_order.get_target());
+}
+
+float ChebyshevTable::get_adaa_delay(int factor) const {
+    // First order ADAA delays by half a sample and second order by a whole one, at the rate the shaper runs at
+    return kind && adaa_order ? adaa_order * 0.5f / factor : 0.0f;
+}
+
+void ChebyshevTable::update_latency() {
+    // The slowest band is either one at the highest factor, or a 1x band with the full ADAA delay
+    latency = roundToInt(HalfbandOversampler::get_latency_in_samples(oversampling_mode, oversampling_stages) + get_adaa_delay(1));
+}
+
+void ChebyshevTable::set_oversampling(int num_stages, HalfbandOversampler::Mode mode) {
+    oversampling_stages = std::clamp(num_stages, 0, HalfbandOversampler::max_stages);
+    oversampling_mode = mode;
+    
+    update_latency();
+    
+    // No need to rebuild anything, the oversamplers are prepared for the maximum factor
+    for(auto& oversampler : oversamplers) {
+        oversampler.set_mode(oversampling_mode);
+    }
+}
+
+
+void ChebyshevTable::set_centre_freqs(std::vector<float> centre_freqs) {
+    filter_freqs = centre_freqs;
+    
+    noise_filters.clear();
+    noise_filters.resize(centre_freqs.size());
+    
+    // Prepare filters at centre frequencies multiplied by polynomial order
+    for(int b = 0; b < filter_freqs.size(); b++) {
+        float centre_freq = std::clamp<float>(filter_freqs[b] * smoothed_order.get_target(), 0, sample_rate / 2 - 1);
+        noise_filters[b].reset();
+        noise_filters[b].prepare(process_spec);
+        noise_filters[b].setType(high_mode ? StateVariableTPTFilterType::bandpass : StateVariableTPTFilterType::highpass);
+        noise_filters[b].setCutoffFrequency(high_mode ? centre_freq : (centre_freq * (2.0f / 3.0f)));
+        //noise_filters[b].setResonance(1.0f / sqrt(2));
+        noise_filters[b].setResonance(1.2f);
+    }
+    
+    oversamplers.resize(filter_freqs.size());
+    latency_delays.clear();
+    last_phase.assign(filter_freqs.size(), std::vector<float>(num_channels, 0.0f));
+    adaa_history.assign(filter_freqs.size(), std::vector<std::array<float, 2>>(num_channels, {0.0f, 0.0f}));
+    band_factors.assign(filter_freqs.size(), 1);
+    
+    for(int b = 0; b < filter_freqs.size(); b++) {
+        oversamplers[b].prepare(num_channels);
+        oversamplers[b].set_mode(oversampling_mode);
+        
+        latency_delays.add(new dsp::DelayLine<float>(64));
+        latency_delays[b]->prepare(process_spec);
+    }
+}
+
+void ChebyshevTable::receive_message(const Identifier& id, float value)  {
+    
+        if(id == Identifier("X")) {
+            //bool kind = changed_tree.getProperty("Kind");
+            order = value * 8.1 + 0.12;
+            smoothed_order.set_target(order);
+            
+            for(int b = 0; b < filter_freqs.size(); b++) {
+                float centre_freq = std::clamp<float>(filter_freqs[b] * smoothed_order.get_target(), 0, sample_rate / 2 - 1);
+                noise_filters[b].setType(high_mode ? StateVariableTPTFilterType::bandpass : StateVariableTPTFilterType::highpass);
+                noise_filters[b].setCutoffFrequency(high_mode ? centre_freq : (centre_freq * (2.0f / 3.0f)));
+            }
+        }
+        else if(id == Identifier("Y")) {
+            float new_gain = 1.0f - value;
+            smoothed_scaling.set_target(new_gain);
+            scaling = new_gain;
+        }
+        else if(id == Identifier("Kind")) {
+            kind = value;
+            update_latency();
+        }
+        else if(id == Identifier("Phase")) {
+            invert_phase = value;
+        }
+        else if(id == Identifier("ModDepth")) {
+            // The LFO itself runs in the processor's LFOBank, the depth is only needed to pick the oversampling factor
+            mod_depth = value;
+        }
+        else if(id == Identifier("ADAA")) {
+            int new_order = std::clamp((int)value, 0, 2);
+            
+            // The history is only kept up to date while ADAA runs
+            if(new_order != adaa_order) {
+                for(auto& band : adaa_history) std::fill(band.begin(), band.end(), std::array<float, 2>{0.0f, 0.0f});
+            }
+            
+            adaa_order = new_order;
+            update_latency();
+        }
+        else if(id == Identifier("Enabled")) {
+            enabled = value;
+        }
+        else if(id == Identifier("Volume")) {
+            float new_volume = value * 1.5f;
+            // Apply volume scaling
+            volume = pow((new_volume + 1.0f), 2.0f) - 1.0f;
+            smoothed_volume.set_target(volume);
+        }
+        else if(id == Identifier("Disharmonic")) {
+            high_mode = !value;
+            
+            // Apply mode to filters
+            for(int b = 0; b < filter_freqs.size(); b++) {
+                float centre_freq = std::clamp<float>(filter_freqs[b] * smoothed_order.get_target(), 0, sample_rate / 2 - 1);
+                noise_filters[b].setType(high_mode ? StateVariableTPTFilterType::bandpass : StateVariableTPTFilterType::highpass);
+                noise_filters[b].setCutoffFrequency(high_mode ? centre_freq : (centre_freq * (2.0f / 3.0f)));
+            }
+        }
+}
@@ -21,218 +21,159 @@
 
 #include "Chromagram.h"
 
+#include <cmath>
+
 //==================================================================================
-Chromagram::Chromagram (int frameSize, int fs)
- :  referenceFrequency (130.81278265),
-    bufferSize (8192),
-    numHarmonics (2),
-    numOctaves (2),
-    numBinsToSearch (2)
+Chromagram::Chromagram (int fs)
 {
     // calculate note frequencies
-    for (int i = 0; i < 12; i++)
+    for (int i = 0; i < numPitchClasses; i++)
     {
-        noteFrequencies[i] = referenceFrequency * pow (2,(((float) i) / 12));
+        noteFrequencies[i] = referenceFrequency * std::pow (2.0f, ((float) i) / 12.0f);
     }
     
-    // set up FFT
-    setupFFT();
-    
-    // set buffer size
     buffer.resize (bufferSize);
     
-    // setup chromagram vector
-    chromagram.resize (12);
-    
-    // initialise chromagram
-    for (int i = 0; i < 12; i++)
-    {
-        chromagram[i] = 0.0;
-    }
-    
-    // setup magnitude spectrum vector
-    magnitudeSpectrum.resize ((bufferSize/2)+1);
-    
-    // make window function
-    makeHammingWindow();
+    fftIn.resize (bufferSize);
+    fftOut.resize (fftPlan.get_num_bins());
+    fftScratch.resize (fftPlan.get_scratch_size());
+    magnitudeSpectrum.resize (fftPlan.get_num_bins());
     
-    // set sampling frequency
     setSamplingFrequency (fs);
-    
-    // set input audio frame size
-    setInputAudioFrameSize (frameSize);
-    
-    // initialise num samples counter
-    numSamplesSinceLastCalculation = 0;
-    
-    // set chroma calculation interval (in samples at the input audio sampling frequency)
-    chromaCalculationInterval = 4096;
-    
-    // initialise chroma ready variable
-    chromaReady = false;
+    reset();
 }
 
 //==================================================================================
-Chromagram::~Chromagram()
+void Chromagram::processAudioFrame (const float* inputAudio, int numSamples)
 {
-    // ------------------------------------
-#ifdef USE_FFTW
-    // destroy fft plan
-    fftw_destroy_plan (p);
-    fftw_free (complexIn);
-    fftw_free (complexOut);
-#endif
-    
-    // ------------------------------------
-#ifdef USE_KISS_FFT
-    // free the Kiss FFT configuration
-    free (cfg);
-    delete [] fftIn;
-    delete [] fftOut;
-#endif
+    processAudioFrame (&inputAudio, 1, numSamples);
 }
 
 //==================================================================================
-void Chromagram::processAudioFrame (float* inputAudioFrame)
+void Chromagram::processAudioFrame (const float* const* inputChannels, int numChannels, int numSamples)
 {
-    // create a vector
-    std::vector<float> v;
+    // second order Butterworth low-pass at a quarter of the sampling frequency
+    const float b0 = 0.2929f, b1 = 0.5858f, b2 = 0.2929f;
+    const float a1 = 0.0f, a2 = 0.1716f;
     
-    // use the array to initialise it
-    v.assign (inputAudioFrame, inputAudioFrame + inputAudioFrameSize);
+    const float channelScale = 1.0f / (float) numChannels;
     
-    // process the vector
-    processAudioFrame (v);
-}
-
-//==================================================================================
-void Chromagram::processAudioFrame (std::vector<float> inputAudioFrame)
-{
     // our default state is that the chroma is not ready
     chromaReady = false;
     
-    // downsample the input audio frame by 4
-    downSampleFrame(inputAudioFrame);
-    
-    // move samples back
-    for (int i = 0; i < bufferSize - downSampledAudioFrameSize; i++)
+    for (int n = 0; n < numSamples; n++)
     {
-        buffer[i] = buffer[i + downSampledAudioFrameSize];
-    }
-    
-    int n = 0;
-    
-    // add new samples to buffer
-    for (int i = (bufferSize - downSampledAudioFrameSize); i < bufferSize; i++)
-    {
-        buffer[i] = downsampledInputAudioFrame[n];
-        n++;
-    }
-    
-    // add number of samples from calculation
-    numSamplesSinceLastCalculation += inputAudioFrameSize;
+        float x = 0.0f;
         
-    // if we have had enough samples
-    if (numSamplesSinceLastCalculation >= chromaCalculationInterval)
-    {
-        // calculate the chromagram
-        calculateChromagram();
+        for (int ch = 0; ch < numChannels; ch++)
+        {
+            x += inputChannels[ch][n];
+        }
+        
+        x *= channelScale;
+        
+        // the filter keeps its state between calls, so block boundaries don't click
+        float y = x * b0 + x1 * b1 + x2 * b2 - y1 * a1 - y2 * a2;
+        
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = y;
+        
+        // keep every fourth filtered sample
+        if (--decimationCounter <= 0)
+        {
+            buffer[writePosition] = y;
+            writePosition = (writePosition + 1) & (bufferSize - 1);
+            decimationCounter = downsamplingFactor;
+        }
         
-        // reset num samples counter
-        numSamplesSinceLastCalculation = 0;
+        if (++numSamplesSinceLastCalculation >= chromaCalculationInterval)
+        {
+            calculateChromagram();
+            numSamplesSinceLastCalculation = 0;
+        }
     }
-    
-}
-
-//==================================================================================
-void Chromagram::setInputAudioFrameSize (int frameSize)
-{
-    inputAudioFrameSize = frameSize;
-    
-    downsampledInputAudioFrame.resize (inputAudioFrameSize / 4);
-    
-    downSampledAudioFrameSize = (int) downsampledInputAudioFrame.size();
 }
 
 //==================================================================================
 void Chromagram::setSamplingFrequency (int fs)
 {
     samplingFrequency = fs;
+    
+    calculateBinRanges();
 }
 
 //==================================================================================
 void Chromagram::setChromaCalculationInterval (int numSamples)
 {
-    chromaCalculationInterval = numSamples;
-}
-
-//==================================================================================
-std::vector<float> Chromagram::getChromagram()
-{
-    return chromagram;
+    chromaCalculationInterval = std::max (numSamples, 1);
 }
 
 //==================================================================================
-bool Chromagram::isReady()
+void Chromagram::reset()
 {
-    return chromaReady;
+    std::fill (buffer.begin(), buffer.end(), 0.0f);
+    chromagram.fill (0.0f);
+    
+    writePosition = 0;
+    decimationCounter = 0;
+    x1 = x2 = y1 = y2 = 0.0f;
+    
+    numSamplesSinceLastCalculation = 0;
+    chromaReady = false;
 }
 
 //==================================================================================
-void Chromagram::setupFFT()
+void Chromagram::calculateBinRanges()
 {
-    // ------------------------------------------------------
-#ifdef USE_FFTW
-    complexIn = (fftw_complex*) fftw_malloc (sizeof (fftw_complex) * bufferSize);		// complex array to hold fft data
-    complexOut = (fftw_complex*) fftw_malloc (sizeof (fftw_complex) * bufferSize);	// complex array to hold fft data
-    p = fftw_plan_dft_1d (bufferSize, complexIn, complexOut, FFTW_FORWARD, FFTW_ESTIMATE);	// FFT plan initialisation
-#endif
-
-    // ------------------------------------------------------
-#ifdef USE_KISS_FFT
-    // initialise the fft time and frequency domain audio frame arrays
-    fftIn = new kiss_fft_cpx[bufferSize];
-    fftOut = new kiss_fft_cpx[bufferSize];
-    cfg = kiss_fft_alloc (bufferSize,0,0,0);
-#endif
+    binRanges.clear();
+    numBinsUsed = 0;
+    
+    // width of one bin in Hz, at the decimated rate
+    float binWidth = ((float) samplingFrequency / downsamplingFactor) / (float) bufferSize;
+    int numBins = fftPlan.get_num_bins();
+    
+    for (int n = 0; n < numPitchClasses; n++)
+    {
+        for (int octave = 1; octave <= numOctaves; octave++)
+        {
+            for (int harmonic = 1; harmonic <= numHarmonics; harmonic++)
+            {
+                int centerBin = (int) std::floor ((noteFrequencies[n] * octave * harmonic) / binWidth + 0.5f);
+                int minBin = std::clamp (centerBin - (numBinsToSearch * harmonic), 0, numBins);
+                int maxBin = std::clamp (centerBin + (numBinsToSearch * harmonic), 0, numBins);
+                
+                binRanges.push_back ({minBin, maxBin, 1.0f / (float) harmonic});
+                numBinsUsed = std::max (numBinsUsed, maxBin);
+            }
+        }
+    }
 }
 
-
 //==================================================================================
 void Chromagram::calculateChromagram()
 {
     calculateMagnitudeSpectrum();
     
-    float divisorRatio = (((float) samplingFrequency) / 4.0) / ((float)bufferSize);
+    const int rangesPerNote = numOctaves * numHarmonics;
     
-    for (int n = 0; n < 12; n++)
+    for (int n = 0; n < numPitchClasses; n++)
     {
-        float chromaSum = 0.0;
+        float chromaSum = 0.0f;
         
-        for (int octave = 1; octave <= numOctaves; octave++)
+        for (int r = 0; r < rangesPerNote; r++)
         {
-            float noteSum = 0.0;
+            auto& range = binRanges[n * rangesPerNote + r];
             
-            for (int harmonic = 1; harmonic <= numHarmonics; harmonic++)
-            {
-                int centerBin = round ((noteFrequencies[n] * octave * harmonic) / divisorRatio);
-                int minBin = centerBin - (numBinsToSearch * harmonic);
-                int maxBin = centerBin + (numBinsToSearch * harmonic);
-                
-                float maxVal = 0.0;
-                
-                for (int k = minBin; k < maxBin; k++)
-                {
-                    if (magnitudeSpectrum[k] > maxVal)
-                    {
-                        maxVal = magnitudeSpectrum[k];
-                    }
-                }
+            float maxVal = 0.0f;
             
-                noteSum += (maxVal / (float) harmonic);
+            for (int k = range.start; k < range.end; k++)
+            {
+                maxVal = std::max (maxVal, magnitudeSpectrum[k]);
             }
             
-            chromaSum += noteSum;
+            chromaSum += maxVal * range.weight;
         }
         
         chromagram[n] = chromaSum;
@@ -244,105 +185,17 @@ void Chromagram::calculateChromagram()
 //==================================================================================
 void Chromagram::calculateMagnitudeSpectrum()
 {
+    // unwrap the ring buffer, oldest sample first, and window it on the way
+    int numOldest = bufferSize - writePosition;
     
-#ifdef USE_FFTW
-    // -----------------------------------------------
-    // FFTW VERSION
-    // -----------------------------------------------
-    int i = 0;
-    
-    for (int i = 0; i < bufferSize; i++)
-    {
-        complexIn[i][0] = buffer[i] * window[i];
-        complexIn[i][1] = 0.0;
-    }
-    
-    // execute fft plan, i.e. compute fft of buffer
-    fftw_execute (p);
-    
-    // compute first (N/2)+1 mag values
-    for (i = 0; i < (bufferSize / 2) + 1; i++)
-    {
-        magnitudeSpectrum[i] = sqrt (pow (complexOut[i][0], 2) + pow (complexOut[i][1], 2));
-        magnitudeSpectrum[i] = sqrt (magnitudeSpectrum[i]);
-    }
-#endif
-    
-    
-#ifdef USE_KISS_FFT
-    // -----------------------------------------------
-    // KISS FFT VERSION
-    // -----------------------------------------------
-    int i = 0;
-    
-    for (int i = 0;i < bufferSize; i++)
-    {
-        fftIn[i].r = buffer[i] * window[i];
-        fftIn[i].i = 0.0;
-    }
-    
-    // execute kiss fft
-    kiss_fft (cfg, fftIn, fftOut);
-    
-    // compute first (N/2)+1 mag values
-    for (i = 0; i < (bufferSize / 2) + 1; i++)
-    {
-        magnitudeSpectrum[i] = sqrt (pow (fftOut[i].r, 2) + pow (fftOut[i].i, 2));
-        magnitudeSpectrum[i] = sqrt (magnitudeSpectrum[i]);
-    }
-#endif
-}
-
-//==================================================================================
-void Chromagram::downSampleFrame (std::vector<float> inputAudioFrame)
-{
-    std::vector<float> filteredFrame (inputAudioFrameSize);
-    
-    float b0,b1,b2,a1,a2;
-    float x_1,x_2,y_1,y_2;
+    FloatVectorOperations::multiply (fftIn.data(), buffer.data() + writePosition, window.data(), numOldest);
+    FloatVectorOperations::multiply (fftIn.data() + numOldest, buffer.data(), window.data() + numOldest, writePosition);
     
-    b0 = 0.2929;
-    b1 = 0.5858;
-    b2 = 0.2929;
-    a1 = -0.0000;
-    a2 = 0.1716;
+    fftPlan.perform (fftIn.data(), fftOut.data(), fftScratch.data());
     
-    x_1 = 0;
-    x_2 = 0;
-    y_1 = 0;
-    y_2 = 0;
-    
-    for (int i = 0; i < inputAudioFrameSize; i++)
+    // compressed magnitude, only up to the highest bin a note looks at
+    for (int i = 0; i < numBinsUsed; i++)
     {
-        filteredFrame[i] = inputAudioFrame[i] * b0 + x_1 * b1 + x_2 * b2 - y_1 * a1 - y_2 * a2;
-        
-        x_2 = x_1;
-        x_1 = inputAudioFrame[i];
-        y_2 = y_1;
-        y_1 = filteredFrame[i];
+        magnitudeSpectrum[i] = std::sqrt (std::sqrt (std::norm (fftOut[i])));
     }
-    
-    for (int i = 0; i < inputAudioFrameSize / 4; i++)
-    {
-        downsampledInputAudioFrame[i] = filteredFrame[i * 4];
-    }
-}
-
-//==================================================================================
-void Chromagram::makeHammingWindow()
-{
-    // set the window to the correct size
-    window.resize (bufferSize);
-    
-    // apply hanning window to buffer
-    for (int n = 0; n < bufferSize;n++)
-    {
-        window[n] = 0.54 - 0.46 * cos (2 * M_PI * (((float) n) / ((float) bufferSize)));
-    }
-}
-
-//==================================================================================
-float Chromagram::round (float val)
-{
-    return floor (val + 0.5);
 }
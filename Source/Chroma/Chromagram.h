@@ -19,125 +19,123 @@
  */
 //=======================================================================
 
-#define USE_KISS_FFT
-
 #ifndef __CHROMAGRAM_H
 #define __CHROMAGRAM_H
 
-#define _USE_MATH_DEFINES
-#include <math.h>
+#include <array>
 #include <vector>
 
-#ifdef USE_FFTW
-#include "fftw3.h"
-#endif
-
-#ifdef USE_KISS_FFT
-#include "../PitchDetection/tools/kiss_fft.h"
-#endif
+#include "../FFTPlan.hpp"
+#include "../WindowCache.hpp"
 
 //=======================================================================
 /** A class for calculating a Chromagram from input audio
- * in a real-time context */
+ * in a real-time context
+ *
+ * The input is low-pass filtered and decimated by 4 into a ring buffer. Every hop
+ * the latest bufferSize decimated samples are windowed and transformed, and each
+ * pitch class takes the strongest bin around its harmonics in each octave.
+ *
+ * Nothing is allocated after construction and setSamplingFrequency(), so it can
+ * run on the audio thread */
 class Chromagram
 {
     
 public:
+    static constexpr int numPitchClasses = 12;
+    
     /** Constructor
-     * @param frameSize the input audio frame size 
      * @param fs the sampling frequency
      */
-    Chromagram (int frameSize, int fs);
-
-    /** Destructor */
-    ~Chromagram();
-    
-    /** Process a single audio frame. This will determine whether enough samples
-     * have been accumulated and if so, will calculate the chromagram
-     * @param inputAudioFrame an array containing the input audio frame. This should be
-     * the length indicated by the input audio frame size passed to the constructor
-     * @see setInputAudioFrameSize
-     */
-    void processAudioFrame (float* inputAudioFrame);
+    Chromagram (int fs = 44100);
     
-    /** Process a single audio frame. This will determine whether enough samples
-     * have been accumulated and if so, will calculate the chromagram
-     * @param inputAudioFrame a vector containing the input audio frame. This should be
-     * the length indicated by the input audio frame size passed to the constructor
-     * @see setInputAudioFrameSize
+    /** Feed input audio, any number of samples at a time. A chroma vector is
+     * calculated every time another hop of input has come in
+     * @param inputAudio the samples
+     * @param numSamples the number of samples
      */
-    void processAudioFrame (std::vector<float> inputAudioFrame);
+    void processAudioFrame (const float* inputAudio, int numSamples);
     
-    /** Sets the input audio frame size
-     * @param frameSize the input audio frame size
+    /** Same, for the average of several channels
+     * @param inputChannels one pointer per channel
+     * @param numChannels the number of channels
+     * @param numSamples the number of samples in each channel
      */
-    void setInputAudioFrameSize (int frameSize);
+    void processAudioFrame (const float* const* inputChannels, int numChannels, int numSamples);
     
-    /** Set the sampling frequency of the input audio
+    /** Set the sampling frequency of the input audio. This recalculates the bin ranges,
+     * so it allocates
      * @param fs the sampling frequency in Hz
      */
     void setSamplingFrequency (int fs);
     
-    /** Set the interval at which the chromagram is calculated. As the algorithm requires
-     * a significant amount of audio to be accumulated, it may be desirable to have the algorithm
-     * not calculate the chromagram at every new audio frame. This function allows you to set the 
-     * interval at which the chromagram will be calculated, specified in the number of samples at
-     * the audio sampling frequency 
-     * @param numSamples the number of samples that the algorithm will receive before calculating a new chromagram
+    /** Set the interval at which the chromagram is calculated, in samples at the input
+     * sampling frequency. Smaller hops follow the music more closely and cost more CPU
+     * @param numSamples the number of samples between two chroma vectors
      */
     void setChromaCalculationInterval (int numSamples);
     
-    /** @returns the chromagram vector */
-    std::vector<float> getChromagram();
+    /** Clears the buffered audio and the chromagram */
+    void reset();
     
-    /** @returns true if a new chromagram vector has been calculated at the current iteration. This should
-     * be called after processAudioFrame
+    /** @returns the latest chromagram vector */
+    const std::array<float, numPitchClasses>& getChromagram() const { return chromagram; }
+    
+    /** @returns true if a new chromagram vector has been calculated during the last call
+     * to processAudioFrame
      */
-    bool isReady();
+    bool isReady() const { return chromaReady; }
     
-    const float* getNoteFrequencies() { return noteFrequencies; };
+    const float* getNoteFrequencies() const { return noteFrequencies.data(); }
     
 private:
     
-    void setupFFT();
+    /** Bins that are searched for the peak of one harmonic of a note */
+    struct BinRange
+    {
+        int start;
+        int end;
+        float weight;
+    };
+    
+    void calculateBinRanges();
     void calculateChromagram();
     void calculateMagnitudeSpectrum();
-	void downSampleFrame (std::vector<float> inputAudioFrame);
-    void makeHammingWindow();
-    float round (float val);
     
-    std::vector<float> window;
+    static constexpr int bufferSize = 8192;
+    static constexpr int downsamplingFactor = 4;
+    static constexpr int numHarmonics = 2;
+    static constexpr int numOctaves = 2;
+    static constexpr int numBinsToSearch = 2;
+    static constexpr float referenceFrequency = 130.81278265f;
+    
+    std::array<float, numPitchClasses> noteFrequencies;
+    std::array<float, numPitchClasses> chromagram;
+    
+    /** numOctaves * numHarmonics ranges per pitch class, one pitch class after the other */
+    std::vector<BinRange> binRanges;
+    int numBinsUsed = 0;
+    
+    /** Decimated input, the newest sample just before writePosition */
     std::vector<float> buffer;
-    std::vector<float> magnitudeSpectrum;
-    std::vector<float> downsampledInputAudioFrame;
-    std::vector<float> chromagram;
-    
-    float referenceFrequency;
-    float noteFrequencies[12];
-    
-    int bufferSize;
-    int samplingFrequency;
-    int inputAudioFrameSize;
-    int downSampledAudioFrameSize;
-    int numHarmonics;
-	int numOctaves;
-	int numBinsToSearch;
-    int numSamplesSinceLastCalculation;
-    int chromaCalculationInterval;
-    bool chromaReady;
-
-#ifdef USE_FFTW
-    fftw_plan p;
-	fftw_complex* complexOut;
-    fftw_complex* complexIn;
-#endif
-    
-#ifdef USE_KISS_FFT
-    kiss_fft_cfg cfg;
-    kiss_fft_cpx* fftIn;
-    kiss_fft_cpx* fftOut;
-#endif
+    int writePosition = 0;
     
+    /** Anti-aliasing filter state, and the input samples left until the next decimated one */
+    float x1 = 0.0f, x2 = 0.0f, y1 = 0.0f, y2 = 0.0f;
+    int decimationCounter = 0;
+    
+    int samplingFrequency = 44100;
+    int numSamplesSinceLastCalculation = 0;
+    int chromaCalculationInterval = 4096;
+    bool chromaReady = false;
+    
+    const std::vector<float>& window = WindowCache::get (WindowCache::hamming, bufferSize);
+    const FFTPlan& fftPlan = FFTPlan::get (bufferSize, FFTPlan::forward);
+    
+    std::vector<float> fftIn;
+    std::vector<FFTPlan::Complex> fftOut;
+    std::vector<FFTPlan::Complex> fftScratch;
+    std::vector<float> magnitudeSpectrum;
 };
 
 #endif /* defined(__CHROMAGRAM_H) */
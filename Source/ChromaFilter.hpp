@@ -9,6 +9,7 @@
 #include "MovingAverage.hpp"
 #include "Chroma/Chromagram.h"
 #include "Filterbanks/GammatoneFilter.hpp"
+#include "WindowCache.hpp"
 
 
 #include <JuceHeader.h>
@@ -17,6 +18,7 @@
 #include <iostream>
 #include <algorithm>
 #include <numeric>
+#include <array>
 #include <vector>
 #include <deque>
 
@@ -41,6 +43,22 @@ struct ChromaFilter
     
     int m_start = 20;
     
+    // Bands whose output stays below the gate threshold for the hold time stop running
+    // The threshold is gate_range (-60 dB) below the loudest band, but never under gate_floor (-80 dB), both in mean square
+    // A cheap probe on the input wakes them up again, before the block that needs them is filtered,
+    // once it reads wake_margin (6 dB) over both the threshold and what it read when the band went to sleep.
+    // The second part keeps bands that the probe hears a bit louder than the filter from flapping
+    static constexpr float gate_floor = 1e-8f;
+    static constexpr float gate_range = 1e-6f;
+    static constexpr float wake_margin = 4.0f;
+    static constexpr float hold_time = 0.25f;
+    
+    // Level the tail is measured down to
+    static constexpr float tail_decibels = -100.0f;
+    
+    static constexpr int num_pitch_classes = 12;
+    static constexpr int all_classes = (1 << num_pitch_classes) - 1;
+    
     ChromaFilter() {
         
         int midi_start = m_start;
@@ -58,13 +76,18 @@ struct ChromaFilter
             frequencies[m - m_start] = pow(2, (m - 69.0f) / 12.0f) * 440.0f;
         }
         
-        output_buffer.resize(num_notes / skip_size, Samples(block_size));
-        
         for(int freq = 0; freq < num_notes; freq++) {
             
             float erb = (frequencies[freq] / q) + min_width;
             filters.add(new GammatoneFilter(sample_rate, block_size, order, frequencies[freq], erb));
             
+            // Hann windowed Goertzel segments of about sample_rate / erb samples: the main lobe reaches about two bandwidths out,
+            // so anything the gammatone passes shows up in the probe, and the sidelobes keep loud bands far away out of it
+            BandGate gate;
+            gate.coefficient = 2.0f * std::cos(MathConstants<float>::twoPi * frequencies[freq] / sample_rate);
+            gate.window_order = std::clamp<int>(std::round(std::log2(sample_rate / erb)), min_window_order, max_window_order);
+            gates.push_back(gate);
+            
             int current_latency = filters.getLast()->calculate_latency();
             latencies.push_back(current_latency);
             
@@ -76,67 +99,362 @@ struct ChromaFilter
         // Delay to add to each filter to sync them up
         for(auto& value : latencies) value = latency - value;
         
+        // A band only sleeps once everything in its delay line is below the threshold too
+        hold_samples = std::max<int>(hold_time * sample_rate, latency);
+        
+        // Each band rings for its own decay time after its compensation delay
+        for(int freq = 0; freq < num_notes; freq++) {
+            tail_samples = std::max(tail_samples, latencies[freq] + filters[freq]->get_decay_samples(tail_decibels));
+        }
+        
+        for(int window_order = min_window_order; window_order <= max_window_order; window_order++) {
+            windows[window_order] = &WindowCache::get(WindowCache::hann, 1 << window_order);
+        }
+        
         for(auto& delay : latencies) {
             delays.add(new dsp::DelayLine<float>(latency));
             delays.getLast()->setDelay(delay);
-            delays.getLast()->prepare({sample_rate, block_size, 1});
         }
+        
+        prepare(1);
     }
     
+    // Sets up buffers and filter state for this many channels, they share the filters and the gates
+    void prepare(int new_num_channels) {
+        jassert(new_num_channels > 0 && new_num_channels <= GammatoneFilter::max_channels);
+        
+        num_channels = std::clamp(new_num_channels, 1, GammatoneFilter::max_channels);
+        
+        for(auto* filter : filters) filter->set_num_channels(num_channels);
+        for(auto* delay : delays) delay->prepare({sample_rate, block_size, (juce::uint32)num_channels});
+        
+        // The previous block, for waking up filters and the first probe segment, then the current block
+        probe_buffers.assign(num_channels, Samples(2 * block_size, 0.0f));
+        
+        output_buffer.resize(num_channels);
+        resize_output();
+        
+        reset();
+    }
     
-    std::vector<Samples> process(Samples channel) {
+    int get_num_channels() const {
+        return num_channels;
+    }
+    
+    // Filters num_channels channels of up to block_size samples, the result is indexed by channel, then band
+    const std::vector<std::vector<Samples>>& process(const float* const* channels, int num_samples) {
+        begin_block(channels, num_samples);
+        
+        for(int band_idx = 0; band_idx < get_num_bands(); band_idx++) process_band(band_idx);
+        
+        return output_buffer;
+    }
+    
+    // The same in steps, so the work can be spread out: begin_block once, then process_band for each band in order
+    // The input has to stay valid until the last band is done
+    void begin_block(const float* const* channels, int num_samples) {
+        threshold = std::max(gate_floor, loudest_energy * gate_range);
+        loudest_energy = 0.0f;
+        
+        class_mask = next_class_mask;
+        
+        block_samples = std::min(num_samples, block_size);
         
-        for(int freq = start; freq < end; freq += skip_size) {
-            int filter_idx = freq - m_start;
-            int band_idx = (freq - start) / skip_size;
+        // The block goes at the end, with what came before in front, so the overlapping probe segments also cover its start
+        for(int ch = 0; ch < num_channels; ch++) {
+            auto& probe_buffer = probe_buffers[ch];
+            std::copy(probe_buffer.begin() + block_samples, probe_buffer.end(), probe_buffer.begin());
+            std::copy(channels[ch], channels[ch] + block_samples, probe_buffer.end() - block_samples);
             
-            jassert(filter_idx >= 0);
-            jassert(band_idx >= 0);
+            inputs[ch] = channels[ch];
+        }
+    }
+    
+    void process_band(int band_idx) {
+        int filter_idx = start + band_idx * skip_size - m_start;
+        
+        jassert(filter_idx >= 0);
+        jassert(band_idx >= 0);
+        
+        // The range can change between two steps of a block
+        if(band_idx >= get_num_bands() || filter_idx < 0 || filter_idx >= (int)gates.size()) return;
+        
+        auto& gate = gates[filter_idx];
+        int num_samples = block_samples;
+        
+        bool selected = is_class_selected(filter_idx);
+        
+        std::array<const float*, GammatoneFilter::max_channels> history;
+        std::array<float*, GammatoneFilter::max_channels> bands;
+        
+        for(int ch = 0; ch < num_channels; ch++) {
+            history[ch] = probe_buffers[ch].data() + block_size - num_samples;
+            bands[ch] = output_buffer[ch][band_idx].data();
+        }
+        
+        // A band that faded out last block and is still not selected goes to sleep
+        if(gate.fading && !selected) {
+            gate.active = false;
+            gate.fading = false;
+            gate.sleep_level = 0.0f;
+            delays[filter_idx]->reset();
+        }
+        
+        if(!gate.active) {
+            // Bands that aren't selected don't even need the probe
+            if(!selected || probe(gate, num_samples) < std::max(threshold, gate.sleep_level) * wake_margin) {
+                filters[filter_idx]->skip(num_samples);
+                for(int ch = 0; ch < num_channels; ch++) std::fill(bands[ch], bands[ch] + block_size, 0.0f);
+                return;
+            }
             
-            filters[filter_idx]->process(channel.data(), output_buffer[band_idx].data(), channel.size());
+            // Whatever was below the threshold still sets the state, starting from silence would click
+            filters[filter_idx]->warm_up(history.data(), bands.data(), num_channels, block_size);
             
-            for(auto& sample : output_buffer[band_idx]) {
-                delays[filter_idx]->pushSample(0, sample);
-                sample = delays[filter_idx]->popSample(0);
+            gate.active = true;
+            gate.hold = 0;
+        }
+        
+        filters[filter_idx]->process(inputs.data(), bands.data(), num_channels, num_samples);
+        
+        // The gate follows the loudest channel, a band that is quiet on one side can still be loud on the other
+        float energy = 0.0f;
+        for(int ch = 0; ch < num_channels; ch++) {
+            energy = std::max(energy, std::inner_product(bands[ch], bands[ch] + num_samples, bands[ch], 0.0f) / std::max(num_samples, 1));
+            
+            for(int n = 0; n < block_size; n++) {
+                delays[filter_idx]->pushSample(ch, bands[ch][n]);
+                bands[ch][n] = delays[filter_idx]->popSample(ch);
             }
         }
+        loudest_energy = std::max(loudest_energy, energy);
+        
+        // Dropping out or coming back while still fading takes a block, so it doesn't click
+        if(!selected) {
+            apply_ramp(bands.data(), num_samples, 1.0f, 0.0f);
+            gate.fading = true;
+            return;
+        }
         
+        if(gate.fading) {
+            apply_ramp(bands.data(), num_samples, 0.0f, 1.0f);
+            gate.fading = false;
+        }
+        
+        if(energy >= threshold) {
+            gate.hold = 0;
+        }
+        else if((gate.hold += num_samples) >= hold_samples) {
+            // Whatever is left in the delay line is below the threshold, drop it
+            gate.active = false;
+            gate.sleep_level = probe(gate, num_samples);
+            delays[filter_idx]->reset();
+        }
+    }
+    
+    const std::vector<std::vector<Samples>>& get_output() const {
         return output_buffer;
     }
     
-    int get_latency() {
+    // One band for every skip_size notes from start up to end
+    int get_num_bands() const {
+        return std::max(0, (end - start + skip_size - 1) / skip_size);
+    }
+    
+    int get_latency() const {
         return latency;
     }
     
+    // Samples after the last input until every band is tail_decibels down
+    int get_tail_samples() const {
+        return tail_samples;
+    }
+    
+    // Chroma selection: only the bands of the num_classes strongest pitch classes run, in every octave
+    // 0 turns it off and runs every band
+    // Bands of a class that drops out fade out over one block and sleep, they wake up through the probe once it's picked again
+    void set_chroma_selection(int num_classes) {
+        num_selected_classes = std::clamp(num_classes, 0, num_pitch_classes);
+        if(num_selected_classes == 0) next_class_mask = all_classes;
+    }
+    
+    int get_chroma_selection() const {
+        return num_selected_classes;
+    }
+    
+    // Picks the classes for the next block from a chromagram, C first
+    // A silent chromagram keeps the classes that were picked before
+    void set_pitch_classes(const std::array<float, num_pitch_classes>& chroma) {
+        if(num_selected_classes == 0) return;
+        
+        std::array<int, num_pitch_classes> classes;
+        std::iota(classes.begin(), classes.end(), 0);
+        std::partial_sort(classes.begin(), classes.begin() + num_selected_classes, classes.end(), [&chroma](int a, int b) {
+            return chroma[a] > chroma[b];
+        });
+        
+        int mask = 0;
+        for(int i = 0; i < num_selected_classes; i++) {
+            if(chroma[classes[i]] > 0.0f) mask |= 1 << classes[i];
+        }
+        
+        if(mask != 0) next_class_mask = mask;
+    }
+    
+    // Centre frequency of the filter behind a band
+    float get_band_frequency(int band_idx) const {
+        int filter_idx = std::clamp(start + band_idx * skip_size - m_start, 0, (int)frequencies.size() - 1);
+        return frequencies[filter_idx];
+    }
+    
+    // Inactive bands output silence, so their waveshapers can be skipped as well
+    bool is_band_active(int band_idx) const {
+        int filter_idx = start + band_idx * skip_size - m_start;
+        return filter_idx >= 0 && filter_idx < (int)gates.size() && gates[filter_idx].active;
+    }
+    
+    // Clears all filters and delay lines, so the next block renders as if from a fresh instance
+    void reset() {
+        for(auto* filter : filters) filter->reset();
+        for(auto* delay : delays) delay->reset();
+        
+        for(auto& channel : output_buffer) {
+            for(auto& band : channel) std::fill(band.begin(), band.end(), 0.0f);
+        }
+        
+        for(auto& gate : gates) {
+            gate.active = true;
+            gate.fading = false;
+            gate.hold = 0;
+            gate.sleep_level = 0.0f;
+        }
+        
+        class_mask = next_class_mask = all_classes;
+        
+        loudest_energy = 0.0f;
+        for(auto& probe_buffer : probe_buffers) std::fill(probe_buffer.begin(), probe_buffer.end(), 0.0f);
+    }
+    
     void set_density(int density) {
         skip_size = density;
-        output_buffer.resize(num_notes / skip_size, Samples(block_size, 0.0f));
+        resize_output();
     }
     
     void set_start(int new_start) {
         start = new_start;
         num_notes = end - start;
         
-        output_buffer.resize(num_notes / skip_size, Samples(block_size, 0.0f));
+        resize_output();
     }
     
     void set_end(int new_end) {
         end = new_end;
         num_notes = end - start;
         
-        output_buffer.resize(num_notes / skip_size, Samples(block_size, 0.0f));
+        resize_output();
     }
     
     
 private:
     
+    static constexpr int min_window_order = 4;
+    static constexpr int max_window_order = 11;
+    
+    struct BandGate
+    {
+        float coefficient = 0.0f;
+        int window_order = min_window_order;
+        
+        bool active = true;
+        int hold = 0;
+        float sleep_level = 0.0f;
+        
+        // Faded out in the last block because its pitch class wasn't selected
+        bool fading = false;
+    };
+    
+    bool is_class_selected(int filter_idx) const {
+        return class_mask & (1 << ((filter_idx + m_start) % num_pitch_classes));
+    }
+    
+    // Linear gain ramp over the block, from the gain before its first sample to the gain at its last
+    void apply_ramp(float* const* bands, int num_samples, float from, float to) const {
+        float increment = (to - from) / std::max(num_samples, 1);
+        
+        for(int ch = 0; ch < num_channels; ch++) {
+            float gain = from;
+            for(int n = 0; n < num_samples; n++) {
+                gain += increment;
+                bands[ch][n] *= gain;
+            }
+            
+            // Past the block, hold the last gain
+            FloatVectorOperations::multiply(bands[ch] + num_samples, to, block_size - num_samples);
+        }
+    }
+    
+    void resize_output() {
+        for(auto& channel : output_buffer) channel.resize(get_num_bands(), Samples(block_size, 0.0f));
+    }
+    
+    // Loudest mean square of the band in any segment of the latest block and any channel, from a Goertzel filter at the centre frequency
+    // Segments overlap by half, so the windows add up to one and nothing slips between them
+    float probe(const BandGate& gate, int num_samples) const {
+        auto& window = *windows[gate.window_order];
+        int length = (int)window.size();
+        int hop = length / 2;
+        
+        float loudest = 0.0f;
+        
+        for(auto& probe_buffer : probe_buffers) {
+            // The first segment starts half a window before the block, the last one ends with it
+            const float* input = probe_buffer.data() + probe_buffer.size() - num_samples - hop;
+            
+            for(int segment = 0; segment + length <= num_samples + hop; segment += hop) {
+                float s1 = 0.0f, s2 = 0.0f;
+                
+                for(int n = 0; n < length; n++) {
+                    float s0 = input[segment + n] * window[n] + gate.coefficient * s1 - s2;
+                    s2 = s1;
+                    s1 = s0;
+                }
+                
+                // A sine at the centre with amplitude A gives |X| = A * length / 4 through the window, so this is A^2 / 2
+                float magnitude = s1 * s1 + s2 * s2 - gate.coefficient * s1 * s2;
+                loudest = std::max(loudest, 8.0f * magnitude / ((float)length * length));
+            }
+        }
+        
+        return loudest;
+    }
+    
     int num_notes = 36;
+    int num_channels = 1;
 
-    std::vector<Samples> output_buffer;
+    std::vector<std::vector<Samples>> output_buffer;
     
     int latency = 800;
     std::vector<int> latencies;
     
     OwnedArray<GammatoneFilter> filters;
     OwnedArray<dsp::DelayLine<float>> delays;
+    
+    std::vector<BandGate> gates;
+    std::array<const std::vector<float>*, max_window_order + 1> windows {};
+    std::vector<Samples> probe_buffers;
+    
+    int hold_samples = 0;
+    float loudest_energy = 0.0f;
+    
+    // State of the block that is being processed in steps
+    std::array<const float*, GammatoneFilter::max_channels> inputs {};
+    int block_samples = 0;
+    float threshold = gate_floor;
+    
+    // Pitch classes that run, bit 0 is C. Picked for the next block and latched when it begins, so a block in flight keeps its bands
+    int num_selected_classes = 0;
+    int class_mask = all_classes;
+    int next_class_mask = all_classes;
+    
+    int tail_samples = 0;
 };
@@ -6,6 +6,8 @@
 //
 
 #include "MovingAverage.hpp"
+#include "WindowCache.hpp"
+#include "FFTPlan.hpp"
 
 
 #include <JuceHeader.h>
@@ -20,28 +22,6 @@ using Sample = float;
 using Samples = std::vector<float>;
 
 
-using WindowFunc = std::function<Sample(float)>;
-
-static inline Sample no_window(float progress) {
-    return 0.5;
-}
-
-static inline Sample hamming_window(float progress) {
-    return 0.54 - 0.46 * cos(2.0 * M_PI * progress);
-}
-
-static inline Sample hanning_window(float progress) {
-    return 0.5 - 0.5 * cos(2.0 * M_PI * progress);
-}
-
-static void apply_window(std::vector<Sample>& samples, WindowFunc window_func) {
-    for (int i = 0; i < samples.size(); i++) {
-        const auto progress = (i - 1.0) / (samples.size() - 1.0);
-        samples[i] *= window_func(progress);
-    }
-}
-
-
 struct DynamicFilter
 {
     
@@ -49,6 +29,7 @@ struct DynamicFilter
     
     static constexpr int block_size = 2048;
     static constexpr int step = 1024;
+    static constexpr int fft_size = 1 << 11;
     static constexpr float sample_rate = 44100.0f;
     
     static constexpr float release_ms = 500.0f;
@@ -72,6 +53,14 @@ struct DynamicFilter
     std::vector<Samples> out_history;
     Samples history;
     
+    // Hamming for the spectrum, Hann for the overlapping output windows
+    const std::vector<float>& analysis_window = WindowCache::get(WindowCache::hamming, block_size);
+    const std::vector<float>& synthesis_window = WindowCache::get(WindowCache::hann, block_size);
+    
+    const FFTPlan& fft_plan = FFTPlan::get(fft_size, FFTPlan::forward);
+    std::vector<FFTPlan::Complex> spectrum;
+    std::vector<FFTPlan::Complex> fft_scratch;
+    
    
     
             
@@ -84,6 +73,9 @@ struct DynamicFilter
         
         freq_decay.resize(1<<13, 0.0f);
         
+        spectrum.resize(fft_plan.get_num_bins());
+        fft_scratch.resize(fft_plan.get_scratch_size());
+        
         output_buffer.resize(num_voices, Samples(block_size, 0.0f));
         
         for(auto& group : svf) {
@@ -96,10 +88,6 @@ struct DynamicFilter
     }
     
     std::vector<Samples> process(Samples channel) {
-        int fft_size = 1<<11;
-        
-        auto fft = dsp::FFT(log2(fft_size));
-        
         for(int g = 0; g < output_buffer.size(); g++) {
             std::fill(output_buffer[g].begin(), output_buffer[g].end(), 0.0f);
             std::fill(current_window[g].begin(), current_window[g].end(), 0.0f);
@@ -114,16 +102,17 @@ struct DynamicFilter
             sample /= filtered_peak;
         }
         
-        apply_window(freq_domain, hamming_window);
-        freq_domain.resize(2 * fft_size, 0.0f);
+        jassert(freq_domain.size() >= block_size);
+        WindowCache::apply(analysis_window, freq_domain.data());
+        freq_domain.resize(fft_size, 0.0f);
         
-        fft.performFrequencyOnlyForwardTransform(freq_domain.data());
+        fft_plan.perform(freq_domain.data(), spectrum.data(), fft_scratch.data());
         
         std::vector<std::pair<float, float>> peaks;
         
         for(int bin = 2; bin < fft_size / 2; bin++)
         {
-            freq_domain[bin] /= fft_size;
+            freq_domain[bin] = std::abs(spectrum[bin]) / fft_size;
             
             
             float frequency = (float)bin * (sample_rate / (fft_size / 2.0f));
@@ -229,7 +218,7 @@ struct DynamicFilter
             
             for(int g = 0; g < peaks.size(); g++) {
                 
-                apply_window(current_window[g], hanning_window);
+                WindowCache::apply(synthesis_window, current_window[g].data());
             
                 for(int i = 0; i < block_size; i++) {
                     int idx = n + i;
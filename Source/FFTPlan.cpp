@@ -0,0 +1,129 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#include "FFTPlan.hpp"
+
+#include <map>
+
+const FFTPlan& FFTPlan::get(int size, Direction direction) {
+    static CriticalSection lock;
+    static std::map<std::pair<int, int>, std::unique_ptr<FFTPlan>> plans;
+    
+    jassert(size > 0 && size % 2 == 0);
+    
+    const ScopedLock scoped_lock(lock);
+    
+    auto& plan = plans[{size, direction}];
+    if(!plan) plan.reset(new FFTPlan(size, direction));
+    
+    return *plan;
+}
+
+FFTPlan::FFTPlan(int fft_size, Direction fft_direction) : size(fft_size), direction(fft_direction) {
+#if ! JUCE_IPP_AVAILABLE
+    if(isPowerOfTwo(size)) {
+        juce_fft = std::make_unique<dsp::FFT>(roundToInt(std::log2(size)));
+        return;
+    }
+#endif
+    
+    // A real FFT of size N is a complex FFT of N / 2 on the even and odd samples, untangled with one twiddle per bin
+    int half_size = size / 2;
+    kiss_plan = kiss_fft_alloc(half_size, direction == inverse, nullptr, nullptr);
+    
+    super_twiddles.resize(half_size / 2);
+    for(int k = 0; k < (int)super_twiddles.size(); k++) {
+        double phase = -MathConstants<double>::pi * ((double)(k + 1) / half_size + 0.5);
+        if(direction == inverse) phase = -phase;
+        
+        super_twiddles[k] = std::polar(1.0f, (float)phase);
+    }
+}
+
+FFTPlan::~FFTPlan() {
+    if(kiss_plan) kiss_fft_free(kiss_plan);
+}
+
+void FFTPlan::perform(const float* input, Complex* output, Complex* scratch) const {
+    jassert(direction == forward);
+    
+    if(juce_fft) {
+        // dsp::FFT works in place on 2 * size floats
+        auto* buffer = reinterpret_cast<float*>(scratch);
+        std::copy(input, input + size, buffer);
+        
+        juce_fft->performRealOnlyForwardTransform(buffer, true);
+        std::copy(scratch, scratch + get_num_bins(), output);
+        return;
+    }
+    
+    int half_size = size / 2;
+    
+    kiss_fft(kiss_plan, reinterpret_cast<const kiss_fft_cpx*>(input), reinterpret_cast<kiss_fft_cpx*>(scratch));
+    
+    output[0] = {scratch[0].real() + scratch[0].imag(), 0.0f};
+    output[half_size] = {scratch[0].real() - scratch[0].imag(), 0.0f};
+    
+    for(int k = 1; k <= half_size / 2; k++) {
+        auto positive = scratch[k];
+        auto negative = std::conj(scratch[half_size - k]);
+        
+        auto even = positive + negative;
+        auto odd = (positive - negative) * super_twiddles[k - 1];
+        
+        output[k] = 0.5f * (even + odd);
+        output[half_size - k] = 0.5f * std::conj(even - odd);
+    }
+}
+
+void FFTPlan::perform(const Complex* input, float* output, Complex* scratch) const {
+    jassert(direction == inverse);
+    
+    if(juce_fft) {
+        // dsp::FFT fills in the negative frequencies itself, and scales the inverse by 1 / size
+        auto* buffer = reinterpret_cast<float*>(scratch);
+        std::copy(input, input + get_num_bins(), scratch);
+        
+        juce_fft->performRealOnlyInverseTransform(buffer);
+        FloatVectorOperations::multiply(output, buffer, (float)size, size);
+        return;
+    }
+    
+    int half_size = size / 2;
+    
+    scratch[0] = {input[0].real() + input[half_size].real(), input[0].real() - input[half_size].real()};
+    
+    for(int k = 1; k <= half_size / 2; k++) {
+        auto positive = input[k];
+        auto negative = std::conj(input[half_size - k]);
+        
+        auto even = positive + negative;
+        auto odd = (positive - negative) * super_twiddles[k - 1];
+        
+        scratch[k] = even + odd;
+        scratch[half_size - k] = std::conj(even - odd);
+    }
+    
+    kiss_fft(kiss_plan, reinterpret_cast<const kiss_fft_cpx*>(scratch), reinterpret_cast<kiss_fft_cpx*>(output));
+}
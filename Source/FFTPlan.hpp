@@ -0,0 +1,85 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include <JuceHeader.h>
+#include <complex>
+
+#include "PitchDetection/tools/kiss_fft.h"
+
+// Real FFT plans, shared by everything in the process
+//
+// Each size and direction is planned the first time it's asked for and stays allocated until the process ends,
+// so instances of the same size share their twiddle tables. get() takes a lock, so call it when preparing and keep the reference.
+// A plan never changes after it's built and the caller passes the scratch memory, so any number of threads can run the same plan at once.
+//
+// Power of two sizes go through dsp::FFT, which picks the fastest engine JUCE was built with (vDSP, FFTW or its own).
+// Other even sizes, and every size in IPP builds (that engine shares a work buffer per object), use kiss_fft at half the size.
+//
+// Neither direction is normalised: a forward and inverse round trip scales by the size
+class FFTPlan
+{
+public:
+    
+    enum Direction
+    {
+        forward,
+        inverse
+    };
+    
+    using Complex = std::complex<float>;
+    
+    static const FFTPlan& get(int size, Direction direction);
+    
+    ~FFTPlan();
+    
+    int get_size() const { return size; }
+    
+    // Number of bins on the spectrum side, size / 2 + 1
+    int get_num_bins() const { return size / 2 + 1; }
+    
+    // Complex values the scratch memory passed to perform() has to hold
+    int get_scratch_size() const { return size; }
+    
+    // Forward: size real samples in, get_num_bins() bins out
+    void perform(const float* input, Complex* output, Complex* scratch) const;
+    
+    // Inverse: get_num_bins() bins in, size real samples out. The imaginary parts of DC and Nyquist are ignored
+    void perform(const Complex* input, float* output, Complex* scratch) const;
+    
+private:
+    
+    FFTPlan(int size, Direction direction);
+    
+    int size;
+    Direction direction;
+    
+    std::unique_ptr<dsp::FFT> juce_fft;
+    
+    kiss_fft_cfg kiss_plan = nullptr;
+    std::vector<Complex> super_twiddles;
+    
+    JUCE_DECLARE_NON_COPYABLE(FFTPlan)
+};
@@ -0,0 +1,198 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#include <array>
+#include <vector>
+
+#include "BiquadBands.hpp"
+
+
+BiquadBands::BiquadBands(ProcessSpec& spec) {
+    sample_rate = spec.sampleRate;
+    num_channels = spec.numChannels;
+    max_block_size = spec.maximumBlockSize;
+
+    x_history.resize(num_channels, {0.0f, 0.0f});
+}
+
+
+void BiquadBands::reset() {
+    y1.assign(num_channels, std::vector<Vec>(num_groups, Vec::expand(0.0f)));
+    y2.assign(num_channels, std::vector<Vec>(num_groups, Vec::expand(0.0f)));
+
+    for(auto& x : x_history) x = {0.0f, 0.0f};
+}
+
+
+void BiquadBands::create_bands(int n_bands, std::pair<float, float> range, float q, float g) {
+    num_bands = n_bands;
+    num_groups = (num_bands + lanes - 1) / lanes;
+
+    centre_freqs.clear();
+    centre_freqs.resize(num_bands, 0.0f);
+
+    c0.assign(num_groups, Vec::expand(0.0f));
+    c1.assign(num_groups, Vec::expand(0.0f));
+    c2.assign(num_groups, Vec::expand(0.0f));
+
+    scratch.assign(max_block_size * num_groups, Vec::expand(0.0f));
+
+    reset();
+
+    float midi_low = ftom(range.first);
+    float midi_high = ftom(range.second);
+
+    for(int i = 0; i < num_bands; i++) {
+        float x = num_bands > 1 ? (float)i / (num_bands - 1.0f) : 0.0f;
+        set_band(i, mtof(jmap(x, midi_low, midi_high)), g, q);
+    }
+}
+
+
+void BiquadBands::set_band(int idx, float freq, float amp, float q) {
+    jassert(idx < num_bands);
+
+    int group = idx / lanes;
+    int lane = idx % lanes;
+
+    centre_freqs[idx] = freq;
+
+    // Is center frequency is below aliasing-cutoff limit?
+    if (freq != 0.0f && freq < 0.5f * sample_rate)
+    {
+        float phase = freq * MathConstants<float>::twoPi / sample_rate;
+        float f_sin = std::sin(phase);
+        float f_cos = std::cos(phase);
+
+        // These formulas are adapted from Robert Bristow-Johnson BLT biquad web posting.
+        // BPF with "constant skirt gain, peak gain = Q", with amplitude scaling of input coefficients.
+        //      alpha = sin(w0)/(2*Q)
+        //      beta  = 1/(1+alpha)
+        //      y[n] = (beta * sin(w0)/2   )  *  (x[n] - x[n-2])
+        //           + (beta * 2*cos(w0)   )  *  y[n-1]
+        //           + (beta * (alpha - 1) )  *  y[n-2]
+        // The input coefficient is scaled by twice the amplitude of the section.
+        float alpha = f_sin / (2.0f * q);
+        float beta = 1.0f / (1.0f + alpha);
+
+        c0[group].set(lane, amp * beta * f_sin);
+        c1[group].set(lane, beta * 2.0f * f_cos);
+        c2[group].set(lane, beta * (alpha - 1.0f));
+    }
+    else
+    {
+        // Frequency is beyond nyquist: silence this section and clear its memory
+        c0[group].set(lane, 0.0f);
+        c1[group].set(lane, 0.0f);
+        c2[group].set(lane, 0.0f);
+
+        for(int ch = 0; ch < num_channels; ch++) {
+            y1[ch][group].set(lane, 0.0f);
+            y2[ch][group].set(lane, 0.0f);
+        }
+    }
+}
+
+
+void BiquadBands::process(const AudioBlock<float>& input, std::vector<AudioBlock<float>>& output) {
+    jassert(output.size() >= num_bands);
+    jassert(input.getNumChannels() <= num_channels);
+
+    int num_samples = (int)input.getNumSamples();
+    int channels = std::min<int>((int)input.getNumChannels(), num_channels);
+
+    // Floats between the same band in two consecutive samples
+    int stride = num_groups * lanes;
+
+    for(int ch = 0; ch < channels; ch++) {
+        auto* in_ptr = input.getChannelPointer(ch);
+        auto& [xm1, xm2] = x_history[ch];
+        auto* y1_ptr = y1[ch].data();
+        auto* y2_ptr = y2[ch].data();
+
+        // The scratch holds max_block_size samples, longer blocks go in pieces
+        for(int start = 0; start < num_samples; start += max_block_size) {
+            int length = std::min(max_block_size, num_samples - start);
+
+            for(int n = 0; n < length; n++) {
+                auto in_diff = Vec::expand(in_ptr[start + n] - xm2);
+                xm2 = xm1;
+                xm1 = in_ptr[start + n];
+
+                auto* frame = scratch.data() + n * num_groups;
+
+                for(int g = 0; g < num_groups; g++) {
+                    auto y = c0[g] * in_diff + c1[g] * y1_ptr[g] + c2[g] * y2_ptr[g];
+                    y2_ptr[g] = y1_ptr[g];
+                    y1_ptr[g] = y;
+                    frame[g] = y;
+                }
+            }
+
+            // Transpose: every band reads one lane out of each frame
+            auto* interleaved = reinterpret_cast<const float*>(scratch.data());
+
+            for(int b = 0; b < num_bands; b++) {
+                auto* out_ptr = output[b].getChannelPointer(ch) + start;
+
+                for(int n = 0; n < length; n++) {
+                    out_ptr[n] = interleaved[n * stride + b];
+                }
+            }
+        }
+    }
+}
+
+
+void BiquadBands::process_summed(const AudioBlock<float>& input, AudioBlock<float>& output) {
+    jassert(input.getNumChannels() <= num_channels);
+
+    int num_samples = (int)input.getNumSamples();
+    int channels = std::min<int>((int)input.getNumChannels(), num_channels);
+
+    for(int ch = 0; ch < channels; ch++) {
+        auto* in_ptr = input.getChannelPointer(ch);
+        auto* out_ptr = output.getChannelPointer(ch);
+        auto& [xm1, xm2] = x_history[ch];
+        auto* y1_ptr = y1[ch].data();
+        auto* y2_ptr = y2[ch].data();
+
+        for(int n = 0; n < num_samples; n++) {
+            auto in_diff = Vec::expand(in_ptr[n] - xm2);
+            xm2 = xm1;
+            xm1 = in_ptr[n];
+
+            // Accumulate all sections in one register, reduce once per sample
+            auto sum = Vec::expand(0.0f);
+            for(int g = 0; g < num_groups; g++) {
+                auto y = c0[g] * in_diff + c1[g] * y1_ptr[g] + c2[g] * y2_ptr[g];
+                y2_ptr[g] = y1_ptr[g];
+                y1_ptr[g] = y;
+                sum += y;
+            }
+
+            out_ptr[n] += sum.sum();
+        }
+    }
+}
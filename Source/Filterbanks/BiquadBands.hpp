@@ -0,0 +1,92 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "Filterbank.hpp"
+
+// Bank of constant-skirt-gain biquad bandpass filters ("modal" filterbank)
+//
+// Based on the SHARC biquad filterbank by Lippold Haken of Haken Audio (2010).
+// The original processes biquads in pairs using the SHARC's SIMD mode,
+// here the sections are grouped per SIMDRegister so we get the same trick on SSE/NEON.
+//
+// For each section k:
+//   y[k](n) = C0[k] * (x(n) - x(n-2)) + C1[k] * y[k](n-1) + C2[k] * y[k](n-2)
+
+struct BiquadBands final : public Filterbank
+{
+    using Vec = SIMDRegister<float>;
+    static constexpr int lanes = (int)Vec::SIMDNumElements;
+
+    static constexpr int default_sections = 64;
+
+    BiquadBands(ProcessSpec& spec);
+
+    static inline float mtof(float midi_note) { return 440.0f * pow(2.0f, (midi_note - 69.0f) / 12.0f); };
+    static inline float ftom(float freq)      { return  69.0f + (12.0f * log2(freq / 440.0f));          };
+
+    // Spread n_bands sections logarithmically over range
+    void create_bands(int n_bands = default_sections, std::pair<float, float> range = {60.0f, 10000.0f}, float q = 12.0f, float g = 1.0f);
+
+    // Coefficient calculation for a single section, adapted from bfbXCoef
+    void set_band(int idx, float freq, float amp, float q);
+
+    // Per-band output mode, processes the channels the bank was prepared for
+    void process(const AudioBlock<float>& input, std::vector<AudioBlock<float>>& output) override;
+
+    // Summed output mode, adds the sum of all sections to output
+    void process_summed(const AudioBlock<float>& input, AudioBlock<float>& output);
+
+    float get_centre_freq(int idx) override {
+        return centre_freqs[idx];
+    }
+
+    int get_num_filters() override {return num_bands; };
+
+    void reset() override;
+
+private:
+
+    float sample_rate;
+    int num_bands = 0;
+    int num_groups = 0;
+    int num_channels;
+
+    std::vector<float> centre_freqs;
+
+    // Coefficients, interleaved so that one register holds 'lanes' sections
+    std::vector<Vec> c0, c1, c2;
+
+    // Filter state per channel: y[n-1], y[n-2] per group, x[n-1], x[n-2] per channel
+    std::vector<std::vector<Vec>> y1, y2;
+    std::vector<std::array<float, 2>> x_history;
+    
+    // Per-band mode renders all groups of a sample next to each other, then transposes into the bands once
+    int max_block_size;
+    std::vector<Vec> scratch;
+};
@@ -1,41 +1,44 @@
-/**********************************************************************
-*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
-*                      Utrecht, the Netherlands
-*                          All rights reserved
-***********************************************************************
-*  This program is free software: you can redistribute it and/or modify
-*  it under the terms of the GNU General Public License as published by
-*  the Free Software Foundation, either version 3 of the License, or
-*  (at your option) any later version.
-*
-*  This program is distributed in the hope that it will be useful,
-*  but WITHOUT ANY WARRANTY; without even the implied warranty of
-*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-*  GNU General Public License for more details.
-*
-*  You should have received a copy of the GNU General Public License
-*  along with this program.
-*  If not, see <http://www.gnu.org/licenses/>.
-***********************************************************************
-*
-*  Author             : Timothy Schoen
-*  E-mail             : timschoen123@gmail.com
-*
-**********************************************************************/
-#pragma once
-#include <JuceHeader.h>
-#include <array>
-#include <vector>
-
-
-struct Filterbank
-{
-    
-    virtual ~Filterbank () {};
-    
-    virtual void process(const AudioBlock<float>& in_buffer, std::vector<AudioBlock<float>>& out_buffer) {};
-    
-    virtual float get_centre_freq(int idx) {return 0; };
-    
-    virtual int get_num_filters() {return 0; };
-};
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+
+struct Filterbank
+{
+    
+    virtual ~Filterbank () {};
+    
+    virtual void process(const AudioBlock<float>& in_buffer, std::vector<AudioBlock<float>>& out_buffer) {};
+    
+    virtual float get_centre_freq(int idx) {return 0; };
+    
+    virtual int get_num_filters() {return 0; };
+    
+    // Clears the filter state, so the next block renders as if from a fresh instance
+    virtual void reset() {};
+};
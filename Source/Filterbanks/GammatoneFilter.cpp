@@ -31,6 +31,8 @@
 #include <JuceHeader.h>
 #include <cmath>
 #include "GammatoneFilter.hpp"
+#include "../Kernels/Kernels.hpp"
+#include "../WindowCache.hpp"
 
 //////////////////////////////////////////////
 GammatoneFilter::GammatoneFilter(double rate, int block_size, unsigned filter_order, float center_freq, float band_width, bool prepare_ir)
@@ -40,8 +42,10 @@ GammatoneFilter::GammatoneFilter(double rate, int block_size, unsigned filter_or
    
     prev_z_real.resize(order);
     prev_z_imag.resize(order);
-    prev_w_real.resize(order);
-    prev_w_imag.resize(order);
+    for(int ch = 0; ch < max_channels; ch++) {
+        prev_w_real[ch].resize(order);
+        prev_w_imag[ch].resize(order);
+    }
     
     temp_buffer_real.resize(order);
     temp_buffer_imag.resize(order);
@@ -55,7 +59,7 @@ GammatoneFilter::GammatoneFilter(double rate, int block_size, unsigned filter_or
     
     
     
-    double phase_increment = f0 * MathConstants<float>::twoPi / sample_rate;
+    phase_increment = f0 * MathConstants<float>::twoPi / sample_rate;
     cos_phase_increment = cos(phase_increment);
     sin_phase_increment = sin(phase_increment);
     
@@ -88,7 +92,7 @@ GammatoneFilter::GammatoneFilter(double rate, int block_size, unsigned filter_or
     latency = max_elt - out_ir.begin();
     
 #if ENABLE_FREQDOMAIN
-    apply_window(out_ir, hamming_window);
+    WindowCache::apply(WindowCache::get(WindowCache::hamming, max_delay), out_ir.data());
     
     AudioBuffer<float> ir_buffer(1, max_delay);
     ir_buffer.addFrom(0, 0, out_ir.data(), max_delay);
@@ -109,7 +113,59 @@ GammatoneFilter::~GammatoneFilter()
 //////////////////////////////////////////////
 void GammatoneFilter::process(const float* inBuffer, float* outBuffer, int num_samples)
 {
+    advance_oscillator(num_samples);
+    
+    FloatVectorOperations::multiply(z_real.data(), cos_phase.data(), inBuffer, num_samples);
+    FloatVectorOperations::multiply(z_imag.data(), sin_phase.data(), inBuffer, num_samples);
+    
+    Kernels::gammatone_cascade(z_real.data(), z_imag.data(), prev_w_real[0].data(), prev_w_imag[0].data(), order, (float)eq_constant, num_samples);
+    
+    FloatVectorOperations::multiply(outBuffer, z_real.data(), cos_phase.data(), num_samples);
+    FloatVectorOperations::addWithMultiply(outBuffer, z_imag.data(), sin_phase.data(), num_samples);
+    
+}
+
+void GammatoneFilter::process(const float* const* input, float* const* output, int num_channels, int num_samples)
+{
+    if(num_channels == 1) {
+        process(input[0], output[0], num_samples);
+        return;
+    }
+    
+    jassert(num_channels == max_channels);
+    jassert(lanes.size() >= (size_t)num_samples * 2 * max_channels);
+    
+    // Both channels go through the same filter, so one oscillator serves them all
+    advance_oscillator(num_samples);
+    
+    for(int k = 0; k < num_samples; k++) {
+        for(int ch = 0; ch < max_channels; ch++) {
+            lanes[k * 4 + ch * 2] = input[ch][k] * cos_phase[k];
+            lanes[k * 4 + ch * 2 + 1] = input[ch][k] * sin_phase[k];
+        }
+    }
     
+    float* state_real[max_channels] = {prev_w_real[0].data(), prev_w_real[1].data()};
+    float* state_imag[max_channels] = {prev_w_imag[0].data(), prev_w_imag[1].data()};
+    
+    Kernels::gammatone_cascade_stereo(lanes.data(), state_real, state_imag, order, (float)eq_constant, num_samples);
+    
+    for(int ch = 0; ch < max_channels; ch++) {
+        for(int k = 0; k < num_samples; k++) {
+            output[ch][k] = lanes[k * 4 + ch * 2] * cos_phase[k] + lanes[k * 4 + ch * 2 + 1] * sin_phase[k];
+        }
+    }
+}
+
+void GammatoneFilter::set_num_channels(int num_channels) {
+    jassert(num_channels > 0 && num_channels <= max_channels);
+    
+    // A single channel uses the separate real and imaginary buffers instead
+    lanes.resize(num_channels > 1 ? cos_phase.size() * 2 * max_channels : 0);
+}
+
+void GammatoneFilter::advance_oscillator(int num_samples)
+{
     for (int k = 0; k < num_samples; k++)
     {
         // TODO: fix with circular buffer instead of branching
@@ -120,26 +176,13 @@ void GammatoneFilter::process(const float* inBuffer, float* outBuffer, int num_s
         sin_phase[k] = cos_phase_increment * old_sin_phase - sin_phase_increment * old_cos_phase;
     }
     
-    last_cos = cos_phase[num_samples - 1];
-    last_sin = sin_phase[num_samples - 1];
+    // The rotation loses a little magnitude every sample, so pull it back onto the unit circle
+    // Without this the output would depend on how long the filter has been running
+    float magnitude = std::sqrt(cos_phase[num_samples - 1] * cos_phase[num_samples - 1] + sin_phase[num_samples - 1] * sin_phase[num_samples - 1]);
+    last_cos = cos_phase[num_samples - 1] / magnitude;
+    last_sin = sin_phase[num_samples - 1] / magnitude;
     
     FloatVectorOperations::negate(sin_phase.data(), sin_phase.data(), num_samples);
-    
-    FloatVectorOperations::multiply(z_real.data(), cos_phase.data(), inBuffer, num_samples);
-    FloatVectorOperations::multiply(z_imag.data(), sin_phase.data(), inBuffer, num_samples);
-    
-    for (int k = 0; k < num_samples; k++)
-    {
-        for (int n = 0; n < order; n++)
-        {
-            prev_w_real[n] = z_real[k] = (z_real[k] - prev_w_real[n]) * eq_constant + prev_w_real[n];
-            prev_w_imag[n] = z_imag[k] = (z_imag[k] - prev_w_imag[n]) * eq_constant + prev_w_imag[n];
-        }
-    }
-    
-    FloatVectorOperations::multiply(outBuffer, z_real.data(), cos_phase.data(), num_samples);
-    FloatVectorOperations::addWithMultiply(outBuffer, z_imag.data(), sin_phase.data(), num_samples);
-    
 }
 
 #if ENABLE_FREQDOMAIN
@@ -167,3 +210,102 @@ float GammatoneFilter::get_centre_freq()
 int GammatoneFilter::calculate_latency() {
     return latency;
 }
+
+int GammatoneFilter::get_decay_samples(float decibels) const {
+    // The impulse response envelope of the cascade is C(t + order - 1, order - 1) * a^t, with a = 1 - eq_constant
+    double log_a = std::log(1.0 - eq_constant);
+    auto log_envelope = [this, log_a](double t) {
+        double result = t * log_a;
+        for(unsigned k = 1; k < order; k++) result += std::log((t + k) / k);
+        return result;
+    };
+    
+    // After its peak the envelope only falls, so search from there
+    double peak = (order - 1) / -log_a;
+    double target = log_envelope(peak) + decibels * std::log(10.0) / 20.0;
+    
+    double low = peak, high = peak + 1.0;
+    while(log_envelope(high) > target) {
+        low = high;
+        high = peak + (high - peak) * 2.0;
+    }
+    
+    while(high - low > 1.0) {
+        double middle = (low + high) / 2.0;
+        if(log_envelope(middle) > target) low = middle;
+        else high = middle;
+    }
+    
+    return (int)std::ceil(high);
+}
+
+void GammatoneFilter::skip(int num_samples) {
+    if(num_samples <= 0) return;
+    
+    // With zero input every stage is w_n[k] = a * w_n[k - 1] + e * w_n-1[k], with e = eq_constant and a = 1 - e
+    // After m samples that becomes w_n[k + m] = a^m * sum_d C(m + d - 1, d) * e^d * w_n-d[k]
+    double a = 1.0 - eq_constant;
+    
+    // The order can't go over the size of an_table
+    std::array<double, 32> weights;
+    jassert(order <= weights.size());
+    
+    weights[0] = std::pow(a, num_samples);
+    for(unsigned d = 1; d < order; d++) {
+        weights[d] = weights[d - 1] * eq_constant * (num_samples + d - 1.0) / d;
+    }
+    
+    // Later stages read the old values of earlier ones, so go backwards
+    for(int ch = 0; ch < max_channels; ch++) {
+        for(int n = order - 1; n >= 0; n--) {
+            double real = 0.0, imag = 0.0;
+            for(int d = 0; d <= n; d++) {
+                real += weights[d] * prev_w_real[ch][n - d];
+                imag += weights[d] * prev_w_imag[ch][n - d];
+            }
+            prev_w_real[ch][n] = real;
+            prev_w_imag[ch][n] = imag;
+        }
+    }
+    
+    turn(num_samples);
+}
+
+void GammatoneFilter::warm_up(const float* history, float* output, int num_samples) {
+    warm_up(&history, &output, 1, num_samples);
+}
+
+void GammatoneFilter::warm_up(const float* const* history, float* const* output, int num_channels, int num_samples) {
+    // Start from silence num_samples ago, the oscillator has to be back there too
+    for(int ch = 0; ch < max_channels; ch++) {
+        std::fill(prev_w_real[ch].begin(), prev_w_real[ch].end(), 0.0f);
+        std::fill(prev_w_imag[ch].begin(), prev_w_imag[ch].end(), 0.0f);
+    }
+    turn(-num_samples);
+    
+    process(history, output, num_channels, num_samples);
+}
+
+void GammatoneFilter::turn(int num_samples) {
+    // The oscillator turns by -phase_increment per sample
+    double angle = std::fmod(phase_increment * num_samples, MathConstants<double>::twoPi);
+    double turn_cos = std::cos(angle), turn_sin = std::sin(angle);
+    
+    float new_cos = turn_cos * last_cos + turn_sin * last_sin;
+    float new_sin = turn_cos * last_sin - turn_sin * last_cos;
+    
+    last_cos = new_cos;
+    last_sin = new_sin;
+}
+
+void GammatoneFilter::reset() {
+    std::fill(prev_z_real.begin(), prev_z_real.end(), 0.0f);
+    std::fill(prev_z_imag.begin(), prev_z_imag.end(), 0.0f);
+    for(int ch = 0; ch < max_channels; ch++) {
+        std::fill(prev_w_real[ch].begin(), prev_w_real[ch].end(), 0.0f);
+        std::fill(prev_w_imag[ch].begin(), prev_w_imag[ch].end(), 0.0f);
+    }
+    
+    last_cos = 1.0f;
+    last_sin = 0.0f;
+}
@@ -1,14 +1,13 @@
 #pragma once
 
 #include <vector>
+#include <array>
 
 
 using Sample = float;
 using Samples = std::vector<float>;
 
 
-using WindowFunc = std::function<Sample(float)>;
-
 #define ENABLE_FREQDOMAIN false
 
 /*
@@ -18,12 +17,21 @@ class GammatoneFilter
 {
 public:
     
+    // Channels that can run through one filter together, they share the oscillator and the cascade runs them side by side
+    static constexpr int max_channels = 2;
+    
     GammatoneFilter(double sample_rate, int block_size, unsigned filter_order, float center_freq, float band_width, bool prepare_ir = true);
     
     ~GammatoneFilter();
     
     void process(const float* inBuffer, float* outBuffer, int num_samples);
     
+    // Filters each channel with its own state, call set_num_channels first
+    void process(const float* const* input, float* const* output, int num_channels, int num_samples);
+    
+    // Makes room for filtering more than one channel at a time
+    void set_num_channels(int num_channels);
+    
 #if ENABLE_FREQDOMAIN
     dsp::Convolution convolution;
     
@@ -34,9 +42,30 @@ public:
     
     int calculate_latency();
     
+    // Time until the impulse response has decayed by the given amount (a negative number of decibels)
+    int get_decay_samples(float decibels) const;
+    
+    // Back to the state right after construction
+    void reset();
+    
+    // Advances the filter by num_samples of silent input without running it
+    // The cascade and the oscillator both have a closed form for that, so this costs the same for any length
+    void skip(int num_samples);
+    
+    // Rebuilds the state from the input that led up to now, so a filter that was skipped can start again without a click
+    // history ends where the next call to process starts, output is scratch space of the same length
+    void warm_up(const float* history, float* output, int num_samples);
+    void warm_up(const float* const* history, float* const* output, int num_channels, int num_samples);
+    
     
 private:
     
+    // Moves the oscillator num_samples ahead, or back for negative values
+    void turn(int num_samples);
+    
+    // Fills cos_phase and sin_phase with the next num_samples of the oscillator, sin_phase comes out negated
+    void advance_oscillator(int num_samples);
+    
     int latency = 0;
     
     double sample_rate;              // Keep the sampling rate at which audio samples were taken
@@ -45,6 +74,7 @@ private:
     double an;                        // filter impluse response proportinality constant
     double cn;                        // constant for bandwidth calculation
     double f0;                        // center freq in Hz (also freq of impulse response tone)
+    double phase_increment;           // phase increment of the filter in radians
     double cos_phase_increment;       // phase increment of the filter
     double sin_phase_increment;       // phase increment of the filter
     double eq_constant;
@@ -52,8 +82,8 @@ private:
     
     std::vector<float> prev_z_real;               // store previous samples between audio buffers
     std::vector<float> prev_z_imag;
-    std::vector<float> prev_w_real;
-    std::vector<float> prev_w_imag;
+    std::array<std::vector<float>, max_channels> prev_w_real;
+    std::array<std::vector<float>, max_channels> prev_w_imag;
     
     std::vector<float> temp_buffer_real;
     std::vector<float> temp_buffer_imag;
@@ -67,6 +97,9 @@ private:
     
     std::vector<float> z_real;
     std::vector<float> z_imag;
+    
+    // Baseband signal of all channels, interleaved for the multichannel cascade
+    std::vector<float> lanes;
     std::vector<float> negated_sin;
     
     float last_cos = 1;
@@ -111,26 +144,4 @@ private:
         0.3334703374675882,
         0.3277208488905608,
     };
-    
-    
-    
-    static inline Sample no_window(float progress) {
-        return 0.5;
-    }
-
-    static inline Sample hamming_window(float progress) {
-        return 0.54 - 0.46 * cos(2.0 * M_PI * progress);
-    }
-
-    static inline Sample hanning_window(float progress) {
-        return 0.5 - 0.5 * cos(2.0 * M_PI * progress);
-    }
-
-    static void apply_window(std::vector<Sample>& samples, WindowFunc window_func) {
-        for (int i = 0; i < samples.size(); i++) {
-            const auto progress = (i - 1.0) / (samples.size() - 1.0);
-            samples[i] *= window_func(progress);
-        }
-    }
-
 };
@@ -133,3 +133,9 @@ void GammatoneFilterBank::process(const AudioBlock<float>& in_buffer, std::vecto
 float GammatoneFilterBank::get_centre_freq(int idx) {
     return filters[0][idx]->get_centre_freq();
 }
+
+void GammatoneFilterBank::reset() {
+    for(auto& channel : filters) {
+        for(auto& filter : channel) filter->reset();
+    }
+}
@@ -27,6 +27,8 @@ public:
     
     float get_centre_freq(int idx) override;
     
+    void reset() override;
+    
     std::vector<std::vector<std::unique_ptr<GammatoneFilter>>> filters;            // Hold the filters in the Bank.
 private:
 
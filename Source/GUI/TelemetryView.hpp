@@ -0,0 +1,115 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Telemetry.hpp"
+#include "../Profiler.hpp"
+#include "LookAndFeel.hpp"
+
+// Live overlay of the engine state: chroma band energies and envelopes, pitch, strongest pitch class and CPU load
+// With ZIRCON_PROFILING it also shows the slowest DSP stage
+// Doesn't take mouse clicks, so it can sit on top of the XY pad
+struct TelemetryView : public Component, private Timer
+{
+    TelemetryView(TripleBuffer<TelemetryFrame>& source) : telemetry(source) {
+        setInterceptsMouseClicks(false, false);
+        setOpaque(false);
+        startTimerHz(30);
+        telemetry.set_reader_active(true);
+    }
+    
+    ~TelemetryView() override {
+        telemetry.set_reader_active(false);
+    }
+    
+    void paint(Graphics& g) override {
+        auto& frame = telemetry.get_read_buffer();
+        
+        auto bounds = getLocalBounds().toFloat().reduced(4.0f, 2.0f);
+        auto text_area = bounds.removeFromRight(110.0f);
+        
+        if(frame.num_bands > 0) {
+            float band_width = bounds.getWidth() / frame.num_bands;
+            
+            Path envelope;
+            
+            for(int b = 0; b < frame.num_bands; b++) {
+                // Map -60..0 dB to the height of the view
+                float energy = normalise(Decibels::gainToDecibels(std::sqrt(frame.chroma_energies[b]), -60.0f));
+                float level = normalise(Decibels::gainToDecibels(frame.band_levels[b], -60.0f));
+                
+                float x = bounds.getX() + b * band_width;
+                
+                g.setColour(Colours::white.withAlpha(0.15f));
+                g.fillRect(x + 1.0f, bounds.getBottom() - energy * bounds.getHeight(), band_width - 2.0f, energy * bounds.getHeight());
+                
+                float y = bounds.getBottom() - level * bounds.getHeight();
+                if(b == 0) envelope.startNewSubPath(x + band_width / 2.0f, y);
+                else       envelope.lineTo(x + band_width / 2.0f, y);
+            }
+            
+            g.setColour(Colours::white.withAlpha(0.5f));
+            g.strokePath(envelope, PathStrokeType(1.0f));
+        }
+        
+        g.setFont(Font(9));
+        g.setColour(Colours::white.withAlpha(0.6f));
+        
+        int num_lines = ZIRCON_PROFILING ? 4 : 3;
+        float line_height = text_area.getHeight() / num_lines;
+        
+        auto pitch = frame.pitch > 0.0f ? String(frame.pitch, 1) + " Hz (" + String(roundToInt(frame.pitch_confidence * 100.0f)) + "%)" : String("-");
+        g.drawText("Pitch: " + pitch, text_area.removeFromTop(line_height), Justification::centredRight);
+        
+        static const StringArray class_names = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+        auto strongest = std::max_element(frame.pitch_classes.begin(), frame.pitch_classes.end());
+        auto pitch_class = *strongest > 0.0f ? class_names[(int)(strongest - frame.pitch_classes.begin())] : String("-");
+        g.drawText("Chroma: " + pitch_class, text_area.removeFromTop(line_height), Justification::centredRight);
+        g.drawText("CPU: " + String(frame.cpu_load * 100.0f, 1) + "%", text_area.removeFromTop(line_height), Justification::centredRight);
+        
+#if ZIRCON_PROFILING
+        // The stage with the worst p99, leaving out the whole block
+        auto stages = Profiler::get_summary();
+        auto slowest = std::max_element(stages.begin() + 1, stages.end(), [](const auto& a, const auto& b) { return a.p99 < b.p99; });
+        
+        if(slowest->count > 0) {
+            g.drawText(slowest->name + " p99: " + String(slowest->p99, 0) + " us", text_area, Justification::centredRight);
+        }
+#endif
+    }
+    
+private:
+    
+    static float normalise(float decibels) {
+        return jlimit(0.0f, 1.0f, (decibels + 60.0f) / 60.0f);
+    }
+    
+    void timerCallback() override {
+        if(telemetry.fetch()) repaint();
+    }
+    
+    TripleBuffer<TelemetryFrame>& telemetry;
+};
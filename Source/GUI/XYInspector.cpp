@@ -34,6 +34,7 @@ XYInspector::XYInspector() {
     drive.set_colour(0);
     volume.set_colour(0);
     kind_select.set_colour(0);
+    adaa_select.set_colour(0);
 
     mod_depth.set_colour(2);
     mod_rate.set_colour(2);
@@ -41,6 +42,7 @@ XYInspector::XYInspector() {
     mod_settings.set_colour(2);
     
     kind_select.set_tooltips({"First kind", "Second kind"});
+    adaa_select.set_tooltips({"No anti-aliasing", "First order anti-aliasing", "Second order anti-aliasing"});
     shape_select.set_tooltips({"Sine", "Square", "Triangle", "Sawtooth"});
     mod_settings.set_tooltips({"Sync to DAW tempo", "Enable/disable stereo"});
     
@@ -132,6 +134,7 @@ XYInspector::XYInspector() {
     
     addAndMakeVisible(settings);
     settings.addAndMakeVisible(kind_select);
+    settings.addAndMakeVisible(adaa_select);
    
     settings.addAndMakeVisible(enabled_button);
     settings.addAndMakeVisible(drive);
@@ -173,7 +176,8 @@ void XYInspector::resized()
     enabled_button.setBounds(0, 0, getWidth() - item_height, item_height);
     delete_slider.setBounds(getWidth() - item_height - 1, 0, item_height, item_height);
     
-    kind_select.setBounds(x_pos + item_width / 6.0f - 2, 35, item_width / 1.5f, 20);
+    kind_select.setBounds(x_pos, 35, item_width / 2.0f - 4, 20);
+    adaa_select.setBounds(x_pos + item_width / 2.0f + 4, 35, item_width / 2.0f - 4, 20);
     
     volume.setBounds(x_pos, 70, item_width - 27, item_height);
     drive.setBounds(x_pos, 105, item_width, item_height);
@@ -229,6 +233,7 @@ void XYInspector::attach_to_tree(ValueTree tree)
     phase_select.getValueObject().referTo(tree.getPropertyAsValue("Phase", nullptr));
     shape_select.getValueObject().referTo(tree.getPropertyAsValue("ModShape", nullptr));
     kind_select.getValueObject().referTo(tree.getPropertyAsValue("Kind", nullptr));
+    adaa_select.getValueObject().referTo(tree.getPropertyAsValue("ADAA", nullptr));
     
     mod_depth.getValueObject().referTo(tree.getPropertyAsValue("ModDepth", nullptr));
     mod_rate.getValueObject().referTo(tree.getPropertyAsValue("ModRate", nullptr));
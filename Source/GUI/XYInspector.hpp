@@ -60,6 +60,7 @@ struct XYInspector : public Component
     TextButton delete_slider = TextButton("x");
     
     SelectorComponent kind_select = SelectorComponent({"I", "II"});
+    SelectorComponent adaa_select = SelectorComponent({"-", "1", "2"});
     
     MultipleSelectorComponent shape_select = MultipleSelectorComponent({"SIN", "TRI", "SQR", "SAW"});
     MultipleSelectorComponent phase_select = MultipleSelectorComponent({juce::CharPointer_UTF8 ("\xc3\x98")});
@@ -50,10 +50,12 @@ void XYSlider::init_valuetree()
         slider_tree.setProperty("Y", position_values.second, nullptr);
         slider_tree.setProperty("Enabled", true, nullptr);
         slider_tree.setProperty("Kind", 0, nullptr);
+        slider_tree.setProperty("ADAA", 0, nullptr);
         slider_tree.setProperty("ModShape", 0, nullptr);
         slider_tree.setProperty("ModDepth", 0.1, nullptr);
         slider_tree.setProperty("ModRate", 5.0f, nullptr);
         slider_tree.setProperty("ModSettings", 0, nullptr);
+        slider_tree.setProperty("ModStereoPhase", 0.5f, nullptr);
         slider_tree.setProperty("Volume", 1.0f, nullptr);
         slider_tree.setProperty("Phase", false, nullptr);
         
@@ -62,12 +64,14 @@ void XYSlider::init_valuetree()
         slider_tree.sendPropertyChangeMessage("X");
         slider_tree.sendPropertyChangeMessage("Y");
         slider_tree.sendPropertyChangeMessage("Kind");
+        slider_tree.sendPropertyChangeMessage("ADAA");
         slider_tree.sendPropertyChangeMessage("Phase");
         slider_tree.sendPropertyChangeMessage("Volume");
         slider_tree.sendPropertyChangeMessage("ModRate");
         slider_tree.sendPropertyChangeMessage("ModDepth");
         slider_tree.sendPropertyChangeMessage("ModShape");
         slider_tree.sendPropertyChangeMessage("ModSettings");
+        slider_tree.sendPropertyChangeMessage("ModStereoPhase");
         slider_tree.sendPropertyChangeMessage("Enabled");
     }
 }
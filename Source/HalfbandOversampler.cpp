@@ -0,0 +1,335 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#include "HalfbandOversampler.hpp"
+
+// Elliptic half-band allpass design, after PolyphaseIir2Designer from HIIR
+// transition is relative to the oversampled rate, the passband ends at 0.25 - transition
+static std::vector<float> design_allpasses(int num_coefs, double transition) {
+    const double pi = MathConstants<double>::pi;
+
+    double k = std::tan((1.0 - transition * 2.0) * pi / 4.0);
+    k *= k;
+
+    double kksqrt = std::pow(1.0 - k * k, 0.25);
+    double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+    double e4 = e * e * e * e;
+    double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+    int order = num_coefs * 2 + 1;
+
+    std::vector<float> coefs(num_coefs);
+
+    for(int c = 1; c <= num_coefs; c++) {
+        double num = 0.0, den = 0.0, term, sign = 1.0;
+
+        int i = 0;
+        do {
+            term = std::pow(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * pi / order) * sign;
+            num += term;
+            sign = -sign;
+            i++;
+        } while(std::abs(term) > 1e-100);
+
+        i = 1;
+        sign = -1.0;
+        do {
+            term = std::pow(q, i * i) * std::cos(i * 2 * c * pi / order) * sign;
+            den += term;
+            sign = -sign;
+            i++;
+        } while(std::abs(term) > 1e-100);
+
+        num *= std::pow(q, 0.25);
+        den += 0.5;
+
+        double ww = (num / den) * (num / den);
+        double x = std::sqrt((1.0 - ww * k) * (1.0 - ww / k)) / (1.0 + ww);
+
+        coefs[c - 1] = (1.0 - x) / (1.0 + x);
+    }
+
+    return coefs;
+}
+
+// Odd taps of a Kaiser windowed half-band FIR with 4 * half_length + 1 taps, scaled for the upsampler
+static std::vector<float> design_fir(int half_length, double beta) {
+    auto bessel_i0 = [](double x) {
+        double sum = 1.0, term = 1.0;
+        for(int k = 1; term > 1e-12 * sum; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    };
+
+    int num_taps = 4 * half_length + 1;
+    int centre = 2 * half_length;
+
+    std::vector<float> taps(2 * half_length);
+    double sum = 0.0;
+
+    for(int i = 0; i < (int)taps.size(); i++) {
+        int n = 2 * i + 1;
+        double m = n - centre;
+        double sinc = std::sin(MathConstants<double>::halfPi * m) / (MathConstants<double>::pi * m);
+        double ratio = 2.0 * n / (num_taps - 1.0) - 1.0;
+        double window = bessel_i0(beta * std::sqrt(1.0 - ratio * ratio)) / bessel_i0(beta);
+
+        taps[i] = sinc * window;
+        sum += taps[i];
+    }
+
+    // Normalise for unity DC gain of the odd phase (the upsampler gain of 2 is included)
+    for(auto& tap : taps) tap /= sum;
+
+    return taps;
+}
+
+const std::array<HalfbandOversampler::StageDesign, HalfbandOversampler::max_stages>& HalfbandOversampler::get_designs() {
+    static const std::array<StageDesign, max_stages> designs = []() {
+        std::array<StageDesign, max_stages> result;
+
+        // The first stage needs the steep transition band, after that the signal only occupies the lower part of the spectrum
+        const std::array<std::pair<int, double>, max_stages> iir_specs = {{{8, 0.04}, {4, 0.1}, {4, 0.1}}};
+
+        // Half lengths are chosen so the round trip latency is a whole number of base rate samples
+        const std::array<std::pair<int, double>, max_stages> fir_specs = {{{16, 8.0}, {6, 7.0}, {4, 6.0}}};
+
+        for(int s = 0; s < max_stages; s++) {
+            auto& design = result[s];
+            float rate = 1 << (s + 1);
+
+            design.allpass_coefs = design_allpasses(iir_specs[s].first, iir_specs[s].second);
+
+            // Each allpass (a + z^-2) / (1 + a z^-2) has a group delay of 2(1 - a)/(1 + a) at DC
+            // The half-band filter delays by the average of both chains plus the one sample offset between them
+            float group_delay = 1.0f;
+            for(auto coef : design.allpass_coefs) group_delay += 2.0f * (1.0f - coef) / (1.0f + coef);
+            group_delay *= 0.5f;
+
+            // The downsampler reads the odd input sample, which saves one sample on the way back
+            design.iir_latency = (2.0f * group_delay - 1.0f) / rate;
+
+            design.fir_delay = fir_specs[s].first;
+            design.fir_taps = design_fir(fir_specs[s].first, fir_specs[s].second);
+            design.fir_latency = (4.0f * design.fir_delay) / rate;
+        }
+
+        return result;
+    }();
+
+    return designs;
+}
+
+float HalfbandOversampler::get_latency_in_samples(Mode mode, int num_stages) {
+    auto& designs = get_designs();
+
+    float latency = 0.0f;
+    for(int s = 0; s < num_stages; s++) {
+        latency += mode == linear_phase ? designs[s].fir_latency : designs[s].iir_latency;
+    }
+
+    return latency;
+}
+
+void HalfbandOversampler::prepare(int num_channels) {
+    auto& designs = get_designs();
+
+    states.resize(num_channels);
+
+    for(auto& channel_states : states) {
+        for(int s = 0; s < max_stages; s++) {
+            auto& state = channel_states[s];
+            int fir_delay = designs[s].fir_delay;
+
+            state.up_allpass.resize(designs[s].allpass_coefs.size() + 2);
+            state.down_allpass.resize(designs[s].allpass_coefs.size() + 2);
+
+            state.up_history.resize(2 * (2 * fir_delay));
+            state.down_even.resize(2 * (fir_delay + 1));
+            state.down_odd.resize(2 * (2 * fir_delay));
+        }
+    }
+
+    reset();
+}
+
+void HalfbandOversampler::reset() {
+    for(auto& channel_states : states) {
+        for(auto& state : channel_states) {
+            std::fill(state.up_allpass.begin(), state.up_allpass.end(), 0.0f);
+            std::fill(state.down_allpass.begin(), state.down_allpass.end(), 0.0f);
+            std::fill(state.up_history.begin(), state.up_history.end(), 0.0f);
+            std::fill(state.down_even.begin(), state.down_even.end(), 0.0f);
+            std::fill(state.down_odd.begin(), state.down_odd.end(), 0.0f);
+            state.up_pos = state.even_pos = state.odd_pos = 0;
+        }
+    }
+}
+
+void HalfbandOversampler::set_mode(Mode new_mode) {
+    if(new_mode == mode) return;
+
+    mode = new_mode;
+    reset();
+}
+
+void HalfbandOversampler::set_num_stages(int new_num_stages) {
+    jassert(new_num_stages >= 0 && new_num_stages <= max_stages);
+
+    new_num_stages = std::clamp(new_num_stages, 0, max_stages);
+
+    if(new_num_stages == num_stages) return;
+
+    // Stages that are switched on start from silence
+    num_stages = new_num_stages;
+    reset();
+}
+
+void HalfbandOversampler::upsample(int channel, const float* input, float* output, float* scratch, int num_samples) {
+    if(num_stages == 0) {
+        std::copy(input, input + num_samples, output);
+        return;
+    }
+
+    // Ping-pong between scratch and output so that the last stage ends up in output
+    const float* source = input;
+
+    for(int s = 0; s < num_stages; s++) {
+        float* destination = ((num_stages - 1 - s) & 1) ? scratch : output;
+
+        upsample_stage(s, states[channel][s], source, destination, num_samples << s);
+        source = destination;
+    }
+}
+
+void HalfbandOversampler::downsample(int channel, float* input, float* output, int num_samples) {
+    if(num_stages == 0) {
+        std::copy(input, input + num_samples, output);
+        return;
+    }
+
+    // Decimating in place is safe: every output sample is written behind the two input samples it reads
+    for(int s = num_stages - 1; s > 0; s--) {
+        downsample_stage(s, states[channel][s], input, input, num_samples << s);
+    }
+
+    downsample_stage(0, states[channel][0], input, output, num_samples);
+}
+
+void HalfbandOversampler::process_allpasses(const std::vector<float>& coefs, float* memory, float& sample_0, float& sample_1) {
+    // memory[i] holds the previous input of section i, memory[i + 2] its previous output
+    int num_coefs = (int)coefs.size();
+
+    for(int i = 0; i < num_coefs; i += 2) {
+        float out_0 = (sample_0 - memory[i + 2]) * coefs[i] + memory[i];
+        float out_1 = (sample_1 - memory[i + 3]) * coefs[i + 1] + memory[i + 1];
+
+        memory[i] = sample_0;
+        memory[i + 1] = sample_1;
+
+        sample_0 = out_0;
+        sample_1 = out_1;
+    }
+
+    memory[num_coefs] = sample_0;
+    memory[num_coefs + 1] = sample_1;
+}
+
+inline int HalfbandOversampler::push(std::vector<float>& history, int pos, float sample) {
+    int length = (int)history.size() / 2;
+
+    pos = (pos == 0 ? length : pos) - 1;
+    history[pos] = history[pos + length] = sample;
+
+    // history[pos + i] is now the sample from i steps ago
+    return pos;
+}
+
+void HalfbandOversampler::upsample_stage(int stage, StageState& state, const float* input, float* output, int num_samples) {
+    auto& design = get_designs()[stage];
+
+    if(mode == low_latency) {
+        for(int n = 0; n < num_samples; n++) {
+            float sample_0 = input[n];
+            float sample_1 = input[n];
+
+            process_allpasses(design.allpass_coefs, state.up_allpass.data(), sample_0, sample_1);
+
+            output[n * 2] = sample_0;
+            output[n * 2 + 1] = sample_1;
+        }
+    }
+    else {
+        const float* taps = design.fir_taps.data();
+        int num_taps = (int)design.fir_taps.size();
+
+        for(int n = 0; n < num_samples; n++) {
+            state.up_pos = push(state.up_history, state.up_pos, input[n]);
+            const float* history = state.up_history.data() + state.up_pos;
+
+            float sum = 0.0f;
+            for(int i = 0; i < num_taps; i++) sum += taps[i] * history[i];
+
+            // The even phase only has the centre tap
+            output[n * 2] = history[design.fir_delay];
+            output[n * 2 + 1] = sum;
+        }
+    }
+}
+
+void HalfbandOversampler::downsample_stage(int stage, StageState& state, const float* input, float* output, int num_samples) {
+    auto& design = get_designs()[stage];
+
+    if(mode == low_latency) {
+        for(int n = 0; n < num_samples; n++) {
+            float sample_0 = input[n * 2 + 1];
+            float sample_1 = input[n * 2];
+
+            process_allpasses(design.allpass_coefs, state.down_allpass.data(), sample_0, sample_1);
+
+            output[n] = 0.5f * (sample_0 + sample_1);
+        }
+    }
+    else {
+        const float* taps = design.fir_taps.data();
+        int num_taps = (int)design.fir_taps.size();
+
+        for(int n = 0; n < num_samples; n++) {
+            float even = input[n * 2];
+            float odd = input[n * 2 + 1];
+
+            state.even_pos = push(state.down_even, state.even_pos, even);
+            const float* odd_history = state.down_odd.data() + state.odd_pos;
+
+            float sum = 0.0f;
+            for(int i = 0; i < num_taps; i++) sum += taps[i] * odd_history[i];
+
+            output[n] = 0.5f * (state.down_even[state.even_pos + design.fir_delay] + sum);
+
+            state.odd_pos = push(state.down_odd, state.odd_pos, odd);
+        }
+    }
+}
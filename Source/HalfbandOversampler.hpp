@@ -0,0 +1,108 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include <JuceHeader.h>
+
+// Cascade of 2x half-band resampling stages, used per band by the Chebyshev waveshaper
+//
+// Two filter designs:
+// - low_latency:  polyphase IIR, two chains of first order allpasses (coefficients designed like Laurent de Soras' HIIR)
+// - linear_phase: Kaiser windowed half-band FIR, only the non-zero taps are evaluated
+//
+// All state is allocated in prepare(), so the factor and mode can be changed on the audio thread.
+// The caller owns the oversampled buffers, that way all bands can share the same scratch memory.
+
+class HalfbandOversampler
+{
+public:
+
+    enum Mode
+    {
+        low_latency,
+        linear_phase
+    };
+
+    static constexpr int max_stages = 3;
+
+    void prepare(int num_channels);
+
+    void reset();
+
+    void set_mode(Mode new_mode);
+    void set_num_stages(int new_num_stages);
+
+    Mode get_mode() const { return mode; }
+    int get_num_stages() const { return num_stages; }
+    int get_factor() const { return 1 << num_stages; }
+
+    // Round trip (upsample + downsample) latency in base rate samples
+    // Exact for linear_phase, for low_latency this is the group delay at DC
+    float get_latency_in_samples() const { return get_latency_in_samples(mode, num_stages); }
+    static float get_latency_in_samples(Mode mode, int num_stages);
+
+    // output and scratch need room for num_samples * get_factor() samples
+    void upsample(int channel, const float* input, float* output, float* scratch, int num_samples);
+
+    // input holds num_samples * get_factor() samples and gets overwritten
+    void downsample(int channel, float* input, float* output, int num_samples);
+
+private:
+
+    struct StageDesign
+    {
+        // Allpass coefficients, even ones go to the first chain, odd ones to the second
+        std::vector<float> allpass_coefs;
+
+        // Odd taps of the FIR (times two), the even phase is a pure delay of fir_delay samples
+        std::vector<float> fir_taps;
+        int fir_delay;
+
+        float iir_latency, fir_latency;
+    };
+
+    struct StageState
+    {
+        std::vector<float> up_allpass, down_allpass;
+
+        // Delay lines are stored twice so we can always read them contiguously
+        std::vector<float> up_history, down_even, down_odd;
+        int up_pos = 0, even_pos = 0, odd_pos = 0;
+    };
+
+    static const std::array<StageDesign, max_stages>& get_designs();
+
+    static void process_allpasses(const std::vector<float>& coefs, float* memory, float& sample_0, float& sample_1);
+
+    static inline int push(std::vector<float>& history, int pos, float sample);
+
+    void upsample_stage(int stage, StageState& state, const float* input, float* output, int num_samples);
+    void downsample_stage(int stage, StageState& state, const float* input, float* output, int num_samples);
+
+    Mode mode = low_latency;
+    int num_stages = 0;
+
+    std::vector<std::array<StageState, max_stages>> states;
+};
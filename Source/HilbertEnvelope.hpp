@@ -1,59 +1,65 @@
-/**********************************************************************
-*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
-*                      Utrecht, the Netherlands
-*                          All rights reserved
-***********************************************************************
-*  This program is free software: you can redistribute it and/or modify
-*  it under the terms of the GNU General Public License as published by
-*  the Free Software Foundation, either version 3 of the License, or
-*  (at your option) any later version.
-*
-*  This program is distributed in the hope that it will be useful,
-*  but WITHOUT ANY WARRANTY; without even the implied warranty of
-*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-*  GNU General Public License for more details.
-*
-*  You should have received a copy of the GNU General Public License
-*  along with this program.
-*  If not, see <http://www.gnu.org/licenses/>.
-***********************************************************************
-*
-*  Author             : Timothy Schoen
-*  E-mail             : timschoen123@gmail.com
-*
-**********************************************************************/
-#pragma once
-#include "EnvelopeFollower.hpp"
-#include <array>
-#include <JuceHeader.h>
-
-
-const float ANTI_DENORMAL_float = 1e-15f;
-
-// hilbert transformer: generates two orthogonal output signals
-// max. phase error for f = 0.00015..0.49985fs is 0.017 degrees
-
-using HilbertState = std::tuple<float, float, std::array<float, 33>, int, float>;
-
-class HilbertEnvelope : public EnvelopeFollower {
-    
-    int num_channels;
-    int num_bands;
-    int oversamp;
-    
-    float release_ms = 80.0f;
-    float alpha_release;
-    
-public:
-    HilbertEnvelope(ProcessSpec& spec, int bands, int oversample_factor);
-    
-    void GetAntiDenormalTable(float* d, int size);
-    
-    void clear();
-    
-    void process(const std::vector<AudioBlock<float>>& in_bands, std::vector<AudioBlock<float>>& out_bands, std::vector<AudioBlock<float>>& inverse_bands, std::vector<AudioBlock<float>>& phase_bands, int num_samples) override;
-    
-private:
-    std::vector<std::vector<HilbertState>> states;
-    float adtab[16];
-};
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+#include "EnvelopeFollower.hpp"
+#include <array>
+#include <JuceHeader.h>
+
+
+const float ANTI_DENORMAL_float = 1e-15f;
+
+// hilbert transformer: generates two orthogonal output signals
+// max. phase error for f = 0.00015..0.49985fs is 0.017 degrees
+
+using HilbertState = std::tuple<float, float, std::array<float, 33>, int, float>;
+
+class HilbertEnvelope : public EnvelopeFollower {
+    
+    int num_channels;
+    int num_bands;
+    int oversamp;
+    
+    float release_ms = 80.0f;
+    float alpha_release;
+    
+public:
+    HilbertEnvelope(ProcessSpec& spec, int bands, int oversample_factor);
+    
+    void GetAntiDenormalTable(float* d, int size);
+    
+    void clear();
+    
+    void reset() override { clear(); }
+    
+    void process(const std::vector<AudioBlock<float>>& in_bands, std::vector<AudioBlock<float>>& out_bands, std::vector<AudioBlock<float>>& inverse_bands, std::vector<AudioBlock<float>>& phase_bands, int num_samples) override;
+    
+private:
+    std::vector<std::vector<HilbertState>> states;
+    
+    // Interleaved real/imag output of the allpass chains
+    std::vector<float> analytic_buffer;
+    std::vector<float> decimated_buffer;
+    float adtab[16];
+};
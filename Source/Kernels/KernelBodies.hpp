@@ -0,0 +1,110 @@
+// Kernel implementations, included once per instruction set level by Kernels.cpp
+// Expects KERNEL_NAMESPACE and KERNEL_TARGET to be defined, so no include guard on purpose!
+
+namespace Kernels::KERNEL_NAMESPACE
+{
+
+KERNEL_TARGET void chebyshev_shape(const float* input, const float* orders, float* output, const ChebyshevPolynomials::TableSet* tables, float gain, int num_samples)
+{
+    using namespace ChebyshevPolynomials;
+
+    // Rows are contiguous, so row i + 1 starts num_polynomials floats after row i
+    const float* values = tables->values[0].data();
+
+    // Work in chunks: the first pass has no memory dependencies and vectorises,
+    // the second pass only does the table reads
+    constexpr int chunk_size = 64;
+    int rows[chunk_size], first_orders[chunk_size];
+    float fracs[chunk_size], amps[chunk_size];
+
+    for(int start = 0; start < num_samples; start += chunk_size) {
+        int length = std::min(chunk_size, num_samples - start);
+
+        for(int n = 0; n < length; n++) {
+            // Find neighboring integer polynomials
+            first_orders[n] = (int)orders[start + n];
+            amps[n] = orders[start + n] - (float)first_orders[n];
+
+            float position = std::min(std::abs(input[start + n]), 1.0f) * table_size;
+            rows[n] = std::min((int)position, table_size - 1);
+            fracs[n] = position - (float)rows[n];
+        }
+
+        for(int n = 0; n < length; n++) {
+            int order = first_orders[n];
+
+            // Both orders and both points are read from two adjacent pairs of floats
+            const float* row = values + rows[n] * num_polynomials + order;
+            float y1 = row[0] + fracs[n] * (row[num_polynomials] - row[0]);
+            float y2 = row[1] + fracs[n] * (row[num_polynomials + 1] - row[1]);
+
+            if(input[start + n] < 0.0f) {
+                y1 *= tables->mirror[order];
+                y2 *= tables->mirror[order + 1];
+            }
+
+            y1 += tables->offsets[order];
+            y2 += tables->offsets[order + 1];
+
+            // Mix the two polynomials together
+            output[start + n] = (y1 + amps[n] * (y2 - y1)) * gain;
+        }
+    }
+}
+
+KERNEL_TARGET void chebyshev_clenshaw(const float* input, const float* orders, float* output, bool second_kind, float gain, int num_samples)
+{
+    for(int n = 0; n < num_samples; n++) {
+        int first_order = (int)orders[n];
+        int second_order = first_order + 1;
+        float amp = orders[n] - (float)first_order;
+
+        float x = std::clamp(input[n], -1.0f, 1.0f);
+
+        // Only two coefficients are non-zero: 1 - amp at first_order and amp at second_order
+        // 0th order polynomial is silence, so its coefficient stays zero
+        float c1 = first_order == 0 ? 0.0f : 1.0f - amp;
+        float c2 = amp;
+
+        // The first kind is (-1)^n * sin(n * pi * x), a sine series in theta = pi * x
+        float theta = MathConstants<float>::pi * x;
+        if(!second_kind) {
+            c1 = (first_order & 1) ? -c1 : c1;
+            c2 = (second_order & 1) ? -c2 : c2;
+        }
+
+        // Clenshaw: b_k = c_k + alpha * b_k+1 - b_k+2, running down to k = 1
+        float alpha = second_kind ? 2.0f * x : 2.0f * std::cos(theta);
+        float b1 = 0.0f, b2 = 0.0f;
+
+        for(int k = second_order; k >= 1; k--) {
+            float c = k == second_order ? c2 : (k == first_order ? c1 : 0.0f);
+            float b0 = c + alpha * b1 - b2;
+            b2 = b1;
+            b1 = b0;
+        }
+
+        float y;
+        if(second_kind) {
+            y = x * b1 - b2 + (float)ChebyshevPolynomials::offset(first_order) * c1 + (float)ChebyshevPolynomials::offset(second_order) * c2;
+        }
+        else {
+            y = b1 * std::sin(theta);
+        }
+
+        output[n] = y * gain;
+    }
+}
+
+KERNEL_TARGET void power_spectrum(float* bins, float scale, int num_bins)
+{
+    for(int i = 0; i < num_bins; i++) {
+        float re = bins[i * 2];
+        float im = bins[i * 2 + 1];
+
+        bins[i * 2] = (re * re + im * im) * scale;
+        bins[i * 2 + 1] = 0.0f;
+    }
+}
+
+}
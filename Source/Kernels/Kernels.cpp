@@ -0,0 +1,240 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+
+#include "Kernels.hpp"
+#include <atomic>
+
+// Target attributes only exist on GCC and Clang, MSVC builds get the generic kernels only
+#if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+#define KERNELS_MULTI_ISA 1
+#else
+#define KERNELS_MULTI_ISA 0
+#endif
+
+#define KERNEL_NAMESPACE generic
+#define KERNEL_TARGET
+#include "KernelBodies.hpp"
+#undef KERNEL_NAMESPACE
+#undef KERNEL_TARGET
+
+#if KERNELS_MULTI_ISA
+
+#define KERNEL_NAMESPACE avx2
+#define KERNEL_TARGET __attribute__((target("avx2,fma")))
+#include "KernelBodies.hpp"
+#undef KERNEL_NAMESPACE
+#undef KERNEL_TARGET
+
+#define KERNEL_NAMESPACE avx512
+#define KERNEL_TARGET __attribute__((target("avx512f,avx512vl,avx2,fma")))
+#include "KernelBodies.hpp"
+#undef KERNEL_NAMESPACE
+#undef KERNEL_TARGET
+
+#endif
+
+namespace Kernels
+{
+
+#define KERNEL_TABLE(name) { Level::name, name::chebyshev_shape, name::chebyshev_clenshaw, name::power_spectrum }
+
+static const KernelTable generic_table = KERNEL_TABLE(generic);
+
+#if KERNELS_MULTI_ISA
+static const KernelTable avx2_table = KERNEL_TABLE(avx2);
+static const KernelTable avx512_table = KERNEL_TABLE(avx512);
+#endif
+
+#undef KERNEL_TABLE
+
+// Start out with the generic kernels so everything works before select() is called
+static std::atomic<const KernelTable*> current_table = &generic_table;
+
+void select(bool force_generic)
+{
+    force_generic |= SystemStats::getEnvironmentVariable("ZIRCON_FORCE_SCALAR", "0").getIntValue() != 0;
+
+    const KernelTable* table = &generic_table;
+
+#if KERNELS_MULTI_ISA
+    if(!force_generic && SystemStats::hasAVX512F() && SystemStats::hasAVX512VL()) {
+        table = &avx512_table;
+    }
+    else if(!force_generic && SystemStats::hasAVX2() && SystemStats::hasFMA3()) {
+        table = &avx2_table;
+    }
+#endif
+
+    current_table.store(table);
+}
+
+const KernelTable& get()
+{
+    return *current_table.load(std::memory_order_relaxed);
+}
+
+String get_level_name()
+{
+    switch (get().level) {
+        case Level::avx512: return "AVX-512";
+        case Level::avx2:   return "AVX2";
+        default:            return SystemStats::hasNeon() ? "NEON" : "Generic";
+    }
+}
+
+// Serial recurrences: every sample depends on the previous one, so wider registers have nothing to work on
+// and one build for the baseline instruction set is all they need
+
+void gammatone_cascade(float* z_real, float* z_imag, float* prev_w_real, float* prev_w_imag, int order, float eq_constant, int num_samples)
+{
+    for (int k = 0; k < num_samples; k++)
+    {
+        for (int n = 0; n < order; n++)
+        {
+            prev_w_real[n] = z_real[k] = (z_real[k] - prev_w_real[n]) * eq_constant + prev_w_real[n];
+            prev_w_imag[n] = z_imag[k] = (z_imag[k] - prev_w_imag[n]) * eq_constant + prev_w_imag[n];
+        }
+    }
+}
+
+void gammatone_cascade_stereo(float* lanes, float* const* prev_w_real, float* const* prev_w_imag, int order, float eq_constant, int num_samples)
+{
+    // One stage of both channels is four lanes: real and imaginary of the left, then of the right channel
+    // The arithmetic is the same as the mono cascade, so a channel comes out the same on either path
+    float state[32][4];
+
+    for (int n = 0; n < order; n++)
+    {
+        state[n][0] = prev_w_real[0][n];
+        state[n][1] = prev_w_imag[0][n];
+        state[n][2] = prev_w_real[1][n];
+        state[n][3] = prev_w_imag[1][n];
+    }
+
+    for (int k = 0; k < num_samples; k++)
+    {
+        float* z = lanes + k * 4;
+
+        for (int n = 0; n < order; n++)
+        {
+            for (int l = 0; l < 4; l++)
+            {
+                state[n][l] = z[l] = (z[l] - state[n][l]) * eq_constant + state[n][l];
+            }
+        }
+    }
+
+    for (int n = 0; n < order; n++)
+    {
+        prev_w_real[0][n] = state[n][0];
+        prev_w_imag[0][n] = state[n][1];
+        prev_w_real[1][n] = state[n][2];
+        prev_w_imag[1][n] = state[n][3];
+    }
+}
+
+void hilbert_allpass(const float* input, float* output, float* s, const float* adn, int num_samples)
+{
+    float xa, xb, adin;
+    for (int i = 0; i < num_samples; i++) {
+        adin = input[i] + adn[i & 1];
+
+        // out1 filter chain: 8 allpasses + 1 unit delay
+        xa = s[1] - 0.999533593f * adin;
+        s[1] = s[0];
+        s[0] = adin + 0.999533593f * xa;
+        xb = s[3] - 0.997023120f * xa;
+        s[3] = s[2];
+        s[2] = xa + 0.997023120f * xb;
+        xa = s[5] - 0.991184054f * xb;
+        s[5] = s[4];
+        s[4] = xb + 0.991184054f * xa;
+        xb = s[7] - 0.975597057f * xa;
+        s[7] = s[6];
+        s[6] = xa + 0.975597057f * xb;
+        xa = s[9] - 0.933889435f * xb;
+        s[9] = s[8];
+        s[8] = xb + 0.933889435f * xa;
+        xb = s[11] - 0.827559364f * xa;
+        s[11] = s[10];
+        s[10] = xa + 0.827559364f * xb;
+        xa = s[13] - 0.590957946f * xb;
+        s[13] = s[12];
+        s[12] = xb + 0.590957946f * xa;
+        xb = s[15] - 0.219852059f * xa;
+        s[15] = s[14];
+        s[14] = xa + 0.219852059f * xb;
+        output[i * 2] = s[32];
+        s[32] = xb;
+
+        // out2 filter chain: 8 allpasses
+        xa = s[17] - 0.998478404f * adin;
+        s[17] = s[16];
+        s[16] = adin + 0.998478404f * xa;
+        xb = s[19] - 0.994786059f * xa;
+        s[19] = s[18];
+        s[18] = xa + 0.994786059f * xb;
+        xa = s[21] - 0.985287169f * xb;
+        s[21] = s[20];
+        s[20] = xb + 0.985287169f * xa;
+        xb = s[23] - 0.959716311f * xa;
+        s[23] = s[22];
+        s[22] = xa + 0.959716311f * xb;
+        xa = s[25] - 0.892466594f * xb;
+        s[25] = s[24];
+        s[24] = xb + 0.892466594f * xa;
+        xb = s[27] - 0.729672406f * xa;
+        s[27] = s[26];
+        s[26] = xa + 0.729672406f * xb;
+        xa = s[29] - 0.413200818f * xb;
+        s[29] = s[28];
+        s[28] = xb + 0.413200818f * xa;
+        output[i * 2 + 1] = s[31] - 0.061990080f * xa;
+        s[31] = s[30];
+        s[30] = xa + 0.061990080f * output[i * 2 + 1];
+    }
+}
+
+void reson_band(const float* input, float* output, float gain, float r, float c1, float c2, float* y_history, const float* x_history, int num_samples)
+{
+    float ym1 = y_history[1];
+    float ym2 = y_history[0];
+    float xm1 = x_history[1];
+    float xm2 = x_history[0];
+
+    for(int n = 0; n < num_samples; n++) {
+        output[n] = gain * (input[n] - r * (double)xm2) + c1 * (double)ym1 + c2 * (double)ym2;
+
+        xm2 = xm1;
+        xm1 = input[n];
+        ym2 = ym1;
+        ym1 = output[n];
+    }
+
+    y_history[0] = ym2;
+    y_history[1] = ym1;
+}
+
+}
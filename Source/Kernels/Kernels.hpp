@@ -0,0 +1,82 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+#include <JuceHeader.h>
+#include "../ChebyshevPolynomials.hpp"
+
+// Runtime CPU dispatch for the hot DSP loops
+// Every kernel in KernelBodies.hpp is compiled once per instruction set level,
+// select() picks the best one for the host CPU.
+// On ARM the generic level is already built for NEON, so there is nothing to pick there.
+//
+// Only kernels whose samples are independent are dispatched, the filter recurrences below the table
+// carry a dependency from one sample to the next and are compiled once.
+
+namespace Kernels
+{
+
+enum class Level
+{
+    generic,
+    avx2,
+    avx512
+};
+
+struct KernelTable
+{
+    Level level;
+
+    // Chebyshev waveshaper: mixes the two integer polynomials around a fractional order
+    void (*chebyshev_shape)(const float* input, const float* orders, float* output, const ChebyshevPolynomials::TableSet* tables, float gain, int num_samples);
+
+    // Same without tables, evaluates the mix with Clenshaw's recurrence
+    void (*chebyshev_clenshaw)(const float* input, const float* orders, float* output, bool second_kind, float gain, int num_samples);
+
+    // In-place |X|^2 * scale on interleaved complex bins, for the autocorrelation in MPM
+    void (*power_spectrum)(float* bins, float scale, int num_bins);
+};
+
+// Pick the implementation for this CPU, call this from prepareToPlay
+// force_generic (or the ZIRCON_FORCE_SCALAR environment variable) selects the generic path for A/B testing
+void select(bool force_generic = false);
+
+const KernelTable& get();
+
+// Cascade of one-pole lowpass stages on the complex baseband signal of a gammatone filter
+void gammatone_cascade(float* z_real, float* z_imag, float* prev_w_real, float* prev_w_imag, int order, float eq_constant, int num_samples);
+
+// The same for two channels at once, on interleaved real/imag pairs of both channels (order is at most 32)
+// The four lanes of a stage fit one SSE or NEON register, so the baseline build already runs them side by side
+void gammatone_cascade_stereo(float* lanes, float* const* prev_w_real, float* const* prev_w_imag, int order, float eq_constant, int num_samples);
+
+// Two 8th order allpass chains with 90 degrees phase difference, writes interleaved real/imag pairs
+void hilbert_allpass(const float* input, float* output, float* state, const float* adn, int num_samples);
+
+// Two-pole resonator with the x[n-2] zero (see ResonBands)
+void reson_band(const float* input, float* output, float gain, float r, float c1, float c2, float* y_history, const float* x_history, int num_samples);
+
+String get_level_name();
+
+}
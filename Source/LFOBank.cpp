@@ -0,0 +1,262 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#include "LFOBank.hpp"
+
+LFOBank::LFOBank() {
+    for(int v = 0; v < max_voices; v++) {
+        reset_voice(v);
+    }
+}
+
+void LFOBank::prepare(const ProcessSpec& spec) {
+    sample_rate = spec.sampleRate;
+    num_channels = spec.numChannels;
+    
+    // Settings survive a prepare, only the smoothing and buffers change
+    for(auto& voice : voices) {
+        voice.frequency.reset(sample_rate, 0.02f);
+        voice.depth.reset(sample_rate, 0.02f);
+    }
+    
+    lane_buffer.resize(spec.maximumBlockSize * max_voices * 2);
+    output_block = AudioBlock<float>(output_data, max_voices * num_channels, spec.maximumBlockSize);
+    output_block.clear();
+}
+
+void LFOBank::reset_voice(int idx) {
+    auto& voice = voices[idx];
+    
+    voice = Voice();
+    voice.frequency.reset(sample_rate, 0.02f);
+    voice.depth.reset(sample_rate, 0.02f);
+    voice.frequency.setCurrentAndTargetValue(2.0f);
+    voice.depth.setCurrentAndTargetValue(0.25f);
+    
+    phase[idx] = 0.0f;
+}
+
+void LFOBank::reset() {
+    for(int v = 0; v < max_voices; v++) {
+        voices[v].frequency.setCurrentAndTargetValue(voices[v].frequency.getTargetValue());
+        voices[v].depth.setCurrentAndTargetValue(voices[v].depth.getTargetValue());
+        phase[v] = 0.0f;
+    }
+}
+
+void LFOBank::add_voice() {
+    jassert(num_voices < max_voices);
+    if(num_voices == max_voices) return;
+    
+    reset_voice(num_voices);
+    num_voices++;
+}
+
+void LFOBank::remove_voice(int idx) {
+    if(idx < 0 || idx >= num_voices) return;
+    
+    std::rotate(voices.begin() + idx, voices.begin() + idx + 1, voices.begin() + num_voices);
+    std::rotate(phase.begin() + idx, phase.begin() + idx + 1, phase.begin() + num_voices);
+    
+    num_voices--;
+    reset_voice(num_voices);
+}
+
+void LFOBank::clear() {
+    for(int v = 0; v < max_voices; v++) {
+        reset_voice(v);
+    }
+    
+    num_voices = 0;
+}
+
+void LFOBank::receive_message(const Identifier& id, float value, int idx) {
+    if(idx < 0 || idx >= num_voices) return;
+    
+    auto& voice = voices[idx];
+    
+    if(id == Identifier("ModDepth")) {
+        voice.depth.setTargetValue(value);
+    }
+    else if(id == Identifier("ModSettings")) {
+        voice.sync = (int)value & 1;
+        voice.stereo = (int)value & 2;
+    }
+    else if(id == Identifier("ModShape")) {
+        voice.shape = std::clamp((int)value, 0, num_shapes - 1);
+    }
+    else if(id == Identifier("ModRate")) {
+        voice.frequency.setTargetValue(value);
+    }
+    else if(id == Identifier("ModStereoPhase")) {
+        voice.stereo_offset = value;
+    }
+}
+
+void LFOBank::process(int num_samples, const TransportState& transport) {
+    auto& tables = get_tables();
+    
+    // Fraction of the phase error to remove this block, independent of the block size
+    float correction = 1.0f - std::exp(-num_samples / (correction_time * sample_rate));
+    
+    // Per block: turn each voice's settings into lane state
+    for(int v = 0; v < max_voices; v++) {
+        auto& voice = voices[v];
+        
+        bool active = v < num_voices && voice.shape != 0;
+        
+        table_start[v] = voice.shape * table_stride;
+        length[v] = std::max(count_bits(voice.shape), 1);
+        offset[v] = active && voice.stereo ? std::fmod(voice.stereo_offset, 1.0f) : 0.0f;
+        
+        float depth_start = voice.depth.getCurrentValue();
+        float depth_end = voice.depth.skip(num_samples);
+        
+        float frequency_start = voice.frequency.getCurrentValue();
+        float frequency_end = voice.frequency.skip(num_samples);
+        
+        depth[v] = active ? depth_start : 0.0f;
+        depth_step[v] = active ? (depth_end - depth_start) / num_samples : 0.0f;
+        
+        if(active && voice.sync && transport.valid) {
+            // Sync rate is the index of the note division
+            float cycles_per_beat = note_divisions[6 - std::clamp((int)voice.frequency.getTargetValue(), 0, 6)];
+            
+            increment[v] = transport.ppq_per_sample * cycles_per_beat;
+            increment_step[v] = 0.0f;
+            
+            // Follow the song position, including where we are in the sequence of shapes
+            if(transport.is_playing) {
+                float target = std::fmod(transport.ppq_position * cycles_per_beat, (double)length[v]);
+                if(target < 0.0f) target += length[v];
+                
+                // Shortest way around the sequence
+                float error = target - phase[v];
+                if(error > length[v] * 0.5f) error -= length[v];
+                else if(error < -length[v] * 0.5f) error += length[v];
+                
+                if(transport.jumped || std::abs(error) > max_phase_correction) {
+                    phase[v] = target;
+                }
+                else {
+                    // Spread the correction over the block as a small change in rate, so the phase never steps
+                    // A slow division over a long block can ask for more than the whole increment back,
+                    // the phase then waits instead of running backwards past the start of the table
+                    increment[v] = std::max(increment[v] + error * correction / num_samples, 0.0f);
+                }
+            }
+        }
+        else {
+            increment[v] = active ? frequency_start * 2.0f / sample_rate : 0.0f;
+            increment_step[v] = active ? (frequency_end - frequency_start) * 2.0f / (sample_rate * num_samples) : 0.0f;
+        }
+    }
+    
+    // All lanes at once, lanes are independent so the inner loops vectorise
+    const float* table = tables.data();
+    float* left = lane_buffer.data();
+    float* right = lane_buffer.data() + num_samples * max_voices;
+    
+    auto read = [table](int start, float position) {
+        float scaled = position * points_per_cycle;
+        int index = (int)scaled;
+        float frac = scaled - (float)index;
+        
+        return table[start + index] + frac * (table[start + index + 1] - table[start + index]);
+    };
+    
+    for(int n = 0; n < num_samples; n++) {
+        for(int v = 0; v < max_voices; v++) {
+            phase[v] += increment[v];
+            increment[v] += increment_step[v];
+            phase[v] -= phase[v] >= length[v] ? length[v] : 0.0f;
+            
+            float right_phase = phase[v] + offset[v];
+            right_phase -= right_phase >= length[v] ? length[v] : 0.0f;
+            
+            left[n * max_voices + v] = read(table_start[v], phase[v]) * depth[v];
+            right[n * max_voices + v] = read(table_start[v], right_phase) * depth[v];
+            
+            depth[v] += depth_step[v];
+        }
+    }
+    
+    // Transpose into one block per voice
+    for(int v = 0; v < num_voices; v++) {
+        for(int ch = 0; ch < num_channels; ch++) {
+            auto* source = ch == 0 ? left : right;
+            auto* destination = output_block.getChannelPointer(v * num_channels + ch);
+            
+            for(int n = 0; n < num_samples; n++) {
+                destination[n] = source[n * max_voices + v];
+            }
+        }
+    }
+}
+
+AudioBlock<float> LFOBank::get_output(int voice, int num_samples) {
+    return output_block.getSubsetChannelBlock(voice * num_channels, num_channels).getSubBlock(0, num_samples);
+}
+
+const std::vector<float>& LFOBank::get_tables() {
+    static const std::vector<float> tables = []() {
+        std::vector<float> result(num_shapes * table_stride, 0.0f);
+        
+        // Sine, square, triangle and sawtooth, one cycle each for t in [0, 1)
+        auto waveform = [](int type, float t) {
+            switch(type) {
+                case 0: return std::sin(t * MathConstants<float>::twoPi - MathConstants<float>::pi);
+                case 1: return t < 0.5f ? -1.0f : 1.0f;
+                case 2: {
+                    t += 0.25f;
+                    if(t >= 1.0f) t -= 1.0f;
+                    return t < 0.5f ? 4.0f * t - 1.0f : 1.0f - 4.0f * (t - 0.5f);
+                }
+                default: return t * 2.0f - 1.0f;
+            }
+        };
+        
+        // Shape 0 stays silent
+        for(int shape = 1; shape < num_shapes; shape++) {
+            std::vector<int> sequence;
+            for(int type = 0; type < 4; type++) {
+                if(shape & (1 << type)) sequence.push_back(type);
+            }
+            
+            float* table = result.data() + shape * table_stride;
+            int num_points = (int)sequence.size() * points_per_cycle;
+            
+            for(int i = 0; i < num_points; i++) {
+                table[i] = waveform(sequence[i / points_per_cycle], (float)(i % points_per_cycle) / points_per_cycle);
+            }
+            
+            // Guard point so interpolation wraps back to the start
+            table[num_points] = table[0];
+        }
+        
+        return result;
+    }();
+    
+    return tables;
+}
@@ -0,0 +1,120 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+#include <JuceHeader.h>
+#include "TransportState.hpp"
+
+// LFOs for all XY sliders, rendered together
+// Every voice is one lane in a structure of arrays, so a single loop advances all of them at once and vectorises across voices
+// Voices are indexed like the distortions, removing one shifts the ones behind it down
+class LFOBank
+{
+public:
+    
+    // Lane count, padded to a full AVX register. Unused lanes are silent
+    static constexpr int max_voices = 8;
+    
+    LFOBank();
+    
+    void prepare(const ProcessSpec& spec);
+    
+    // Voice management, mirrors the XY sliders
+    void add_voice();
+    void remove_voice(int idx);
+    void clear();
+    
+    // Restarts all voices from phase 0, keeps their settings
+    void reset();
+    
+    void receive_message(const Identifier& id, float value, int idx);
+    
+    // Synced voices follow the transport: the rate comes from the tempo and the phase is pulled towards the song position
+    void process(int num_samples, const TransportState& transport);
+    
+    // Modulation for one voice, one channel per output channel
+    AudioBlock<float> get_output(int voice, int num_samples);
+    
+private:
+    
+    struct Voice
+    {
+        int shape = 0;
+        bool sync = false, stereo = false;
+        
+        // Phase offset of the right channel in cycles, 0.5 sounds like the old inverted channel
+        float stereo_offset = 0.5f;
+        
+        SmoothedValue<float> frequency, depth;
+    };
+    
+    void reset_voice(int idx);
+    
+    int num_voices = 0;
+    int num_channels = 2;
+    float sample_rate = 44100.0f;
+    
+    std::array<Voice, max_voices> voices;
+    
+    // Lane state
+    alignas(32) std::array<float, max_voices> phase {}, increment {}, increment_step {}, depth {}, depth_step {}, length {}, offset {};
+    alignas(32) std::array<int, max_voices> table_start {};
+    
+    // Lane-interleaved render target, per sample all voices next to each other
+    std::vector<float> lane_buffer;
+    
+    AudioBlock<float> output_block;
+    HeapBlock<char> output_data;
+    
+    // Cycles per quarter note for each sync division
+    static constexpr std::array<float, 7> note_divisions = { 1.0f / 1.0f * 4.0f,
+                                                             1.0f / 2.0f * 4.0f,
+                                                             1.0f / 4.0f * 4.0f,
+                                                             1.0f / 8.0f * 4.0f,
+                                                             1.0f / 16.0f * 4.0f,
+                                                             1.0f / 32.0f * 4.0f,
+                                                             1.0f / 64.0f * 4.0f };
+    
+    // Phase errors above this many cycles are jumped over instead of corrected, like after a loop or a locate
+    static constexpr float max_phase_correction = 0.25f;
+    
+    // Time constant of the phase correction
+    static constexpr float correction_time = 0.05f;
+    
+    // One table per shape bitmask, the selected waveforms are played one after the other
+    static constexpr int num_shapes = 16;
+    static constexpr int points_per_cycle = 128;
+    static constexpr int table_stride = points_per_cycle * 4 + 1;
+    
+    static const std::vector<float>& get_tables();
+    
+    static int count_bits(int n) {
+        int count = 0;
+        while (n) {
+            n &= (n - 1);
+            count++;
+        }
+        return count;
+    }
+};
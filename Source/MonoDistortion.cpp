@@ -13,24 +13,33 @@
 #include <vector>
 
 
-MonoDistortion::MonoDistortion(){
-    block.resize(block_size);
-    amp_channel.resize(block_size);
-    amp_history.resize(block_size);
-    freq_buffer.resize(block_size);
-    history.resize(block_size, 0.0f);
-    out_history.resize(block_size, 0.0f);
-    current_window.resize(block_size, 0.0f);
+void MonoDistortion::ShaperStream::prepare(const ProcessSpec& spec) {
+    oversampler.prepare(spec.numChannels);
+    oversampler.reset();
+    
+    alignment.prepare(spec);
+    
+    adaa_history.assign(spec.numChannels, {0.0f, 0.0f});
+}
+
+void MonoDistortion::ShaperStream::reset() {
+    oversampler.reset();
+    alignment.reset();
+    
+    std::fill(adaa_history.begin(), adaa_history.end(), std::array<float, 2> {0.0f, 0.0f});
+}
+
+MonoDistortion::ChannelState::ChannelState(float sample_rate) {
     input_buffer.resize(block_size, 0.0f);
-    future_buffer.resize(block_size, 0.0f);
+    output_buffer.resize(block_size, 0.0f);
+    last_input.resize(block_size, 0.0f);
+    next_output.resize(block_size, 0.0f);
     
-    amp_delay_line.resize(block_size * 2.0f, 0.0f);
-    delay_line.resize(block_size * 2.0f, 0.0f);
+    frame.resize(block_size, 0.0f);
+    window.resize(block_size, 0.0f);
     
     poly_filtered_peak.resize(128, 0.0f);
     
-    rate_shifter.prepare({sample_rate, block_size, 1});
-    
     for(auto& group : svf) {
         for(auto& filter : group) {
             filter.prepare({sample_rate, block_size, 8});
@@ -39,37 +48,326 @@ MonoDistortion::MonoDistortion(){
         }
     }
     
+    for(auto& stream : streams) stream.prepare({sample_rate, block_size, 1});
+}
+
+void MonoDistortion::ChannelState::reset() {
+    for(auto* buffer : {&input_buffer, &output_buffer, &last_input, &next_output, &frame, &window, &poly_filtered_peak}) {
+        std::fill(buffer->begin(), buffer->end(), 0.0f);
+    }
+    
+    filtered_peak = 0.0f;
+    
+    for(auto& group : svf) {
+        for(auto& filter : group) filter.reset();
+    }
+    
+    for(auto& stream : streams) stream.reset();
+}
+
+MonoDistortion::Analysis::Analysis() {
+    // Dividing by a silent envelope gives silence, not a NaN
+    amplitude.resize(block_size, 1e-7f);
+}
+
+void MonoDistortion::Analysis::reset() {
+    std::fill(amplitude.begin(), amplitude.end(), 1e-7f);
+    
+    frequency = 0.0f;
+    confidence = 0.0f;
+    peak_amp = 0.0f;
+    last_pitch = 0.0f;
+    
+    estimates.fill({});
+    missed_hops = 0;
+    
+    hilbert.clear();
+}
+
+MonoDistortion::MonoDistortion(){
+    block.resize(block_size);
+    hop_buffer.resize(step);
+    mid_buffer.resize(block_size, 0.0f);
+    hilbert_output.resize(step);
+    
+    for(auto* buffer : {&shaper_input, &shaper_gain, &shaper_output}) buffer->resize(block_size, 0.0f);
+    for(auto* buffer : {&oversampled_input, &oversampled_angle, &oversampled_output}) buffer->resize(block_size << HalfbandOversampler::max_stages, 0.0f);
+    
+    linked_peak.resize(128, 0.0f);
+    chroma_energy.resize(128, 0.0f);
+    
+    chromagram.setSamplingFrequency(sample_rate);
+    chromagram.setChromaCalculationInterval(chroma_hop);
     
     downsample_filter.setCoefficients(IIRCoefficients::makeLowPass(sample_rate, 22050.0f / 4.0f, 1.0f / sqrt(2.0f)));
     
+    for(auto& voice : voices) {
+        voice.order.prepare(sample_rate, smoothing_time, block_size);
+        voice.amplitude.prepare(sample_rate, smoothing_time, block_size);
+    }
+    
+    compression_amt.prepare(sample_rate, smoothing_time, block_size);
+    compression_amt.set_current_and_target(0.5f);
+    
+    prepare(1);
 }
 
+void MonoDistortion::prepare(int num_channels) {
+    jassert(num_channels > 0 && num_channels <= GammatoneFilter::max_channels);
+    
+    num_channels = std::clamp(num_channels, 1, GammatoneFilter::max_channels);
+    
+    channels.clear();
+    analyses.clear();
+    for(int ch = 0; ch < num_channels; ch++) {
+        channels.add(new ChannelState(sample_rate));
+        analyses.add(new Analysis());
+    }
+    
+    // The chroma bands of all channels run through the same filters
+    chroma_filter.prepare(num_channels);
+    
+    band_streams.clear();
+    for(int band = 0; band < (int)linked_peak.size(); band++) {
+        band_streams.add(new ShaperStream())->prepare({sample_rate, block_size, (juce::uint32)num_channels});
+    }
+    
+    set_oversampling(oversampling_stages, oversampling_mode);
+    
+    lfo_bank.prepare({sample_rate, (juce::uint32)block_size, (juce::uint32)num_channels});
+    
+    for(auto& voice_modulation : modulation) {
+        voice_modulation.assign(num_channels, Samples(block_size, 0.0f));
+    }
+    
+    scheduler.prepare(num_channels, block_size, step, render_delay + block_size);
+    scheduler.set_work(get_num_slices(), [this](int slice) { run_slice(slice); });
+    poly_executor.set_work([this](int slice) { run_poly_slice(slice); });
+    
+    reset();
+}
 
-void MonoDistortion::receive_message(const Identifier& id, float value, int idx)  {
+void MonoDistortion::reset() {
+    for(auto* buffer : {&block, &hop_buffer, &mid_buffer}) {
+        std::fill(buffer->begin(), buffer->end(), 0.0f);
+    }
     
-    auto& [harmonic, amp, phase] = harmonics[idx];
-    if(id == Identifier("X")) {
-        //bool kind = changed_tree.getProperty("Kind");
-        //order = value * 8.1 + 0.12;
-        //smoothed_order.setTargetValue(order);
-        harmonic = value * 8.1 + 0.12;
+    std::fill(hilbert_output.begin(), hilbert_output.end(), 0.0f);
+    
+    fifo_idx = 0;
+    generation++;
+    poly_executor.cancel();
+    scheduler.reset();
+    
+    for(auto* state : channels) state->reset();
+    for(auto* analysis : analyses) analysis->reset();
+    for(auto* stream : band_streams) stream->reset();
+    
+    std::fill(linked_peak.begin(), linked_peak.end(), 0.0f);
+    std::fill(chroma_energy.begin(), chroma_energy.end(), 0.0f);
+    num_chroma_bands = 0;
+    
+    chroma_filter.reset();
+    chromagram.reset();
+    
+    for(auto& voice : voices) {
+        voice.order.set_current_and_target(voice.order.get_target());
+        voice.amplitude.set_current_and_target(voice.amplitude.get_target());
+    }
+    
+    compression_amt.set_current_and_target(compression_amt.get_target());
+    
+    lfo_bank.reset();
+    transport_jumped = true;
+    
+    for(auto& voice_modulation : modulation) {
+        for(auto& history : voice_modulation) std::fill(history.begin(), history.end(), 0.0f);
+    }
+}
+
+void MonoDistortion::restart_stream() {
+    poly_executor.cancel();
+    fifo_idx = 0;
+    
+    for(auto* state : channels) {
+        for(auto* buffer : {&state->input_buffer, &state->output_buffer, &state->last_input, &state->next_output}) {
+            std::fill(buffer->begin(), buffer->end(), 0.0f);
+        }
+    }
+    
+    // The hop count starts over with the scheduler, so estimates from the analysis thread no longer line up
+    scheduler.reset();
+    generation++;
+    
+    for(auto* analysis : analyses) {
+        analysis->estimates.fill({});
+        analysis->missed_hops = 0;
+    }
+    
+    transport_jumped = true;
+}
+
+void MonoDistortion::advance_parameters(int num_samples) {
+    for(auto& voice : voices) {
+        voice.order.process(num_samples);
+        voice.amplitude.process(num_samples);
+    }
+    
+    compression_amt.process(num_samples);
+    
+    lfo_bank.process(num_samples, transport);
+    
+    for(int v = 0; v < max_voices; v++) {
+        auto lfo = lfo_bank.get_output(v, num_samples);
         
-        rate_shifter.set_ratio(harmonic);
+        for(int ch = 0; ch < (int)modulation[v].size(); ch++) {
+            auto& history = modulation[v][ch];
+            auto* output = lfo.getChannelPointer(ch);
+            
+            std::copy(history.begin() + num_samples, history.end(), history.begin());
+            std::copy(output, output + num_samples, history.end() - num_samples);
+        }
+    }
+    
+    // Both modes read at most the whole modulation history before the next call
+    highest_order = 0.0f;
+    for(int v = 0; v < max_voices; v++) {
+        auto& voice = voices[v];
+        if(voice.is_silent()) continue;
+        
+        float modulation_peak = 0.0f;
+        for(auto& history : modulation[v]) {
+            modulation_peak = std::max(modulation_peak, FloatVectorOperations::findMaximum(history.data(), block_size));
+        }
         
+        highest_order = std::max(highest_order, std::max(voice.order.get_current(), voice.order.get_target()) + modulation_peak);
+    }
+}
+
+void MonoDistortion::follow_transport(int offset, int num_samples) {
+    transport = host_transport;
+    transport.ppq_position = host_transport.get_ppq(offset);
+    transport.num_samples = num_samples;
+    transport.jumped = transport_jumped;
+    
+    transport_jumped = false;
+}
+
+int MonoDistortion::get_tail_samples() const {
+    // Poly mode hands out each sample two blocks after it went in, and rings as long as the chroma bands
+    int poly_tail = 2 * block_size + chroma_filter.get_tail_samples();
+    
+    // Mono mode renders the signal after its delay, the last window reaches one window further and comes out a hop later
+    int mono_tail = render_delay + block_size + scheduler.get_latency();
+    
+    return std::max(poly_tail, mono_tail) + get_oversampling_latency();
+}
+
+int MonoDistortion::get_latency() const {
+    if(!poly) return render_delay + block_size + scheduler.get_latency() + get_oversampling_latency();
+    
+    return 2 * block_size + chroma_filter.get_latency() + get_oversampling_latency();
+}
+
+int MonoDistortion::get_oversampling_latency() const {
+    return roundToInt(HalfbandOversampler::get_latency_in_samples(oversampling_mode, oversampling_stages));
+}
+
+void MonoDistortion::set_oversampling(int num_stages, HalfbandOversampler::Mode mode) {
+    oversampling_stages = std::clamp(num_stages, 0, HalfbandOversampler::max_stages);
+    oversampling_mode = mode;
+    
+    // Only resets the oversamplers when it changes, each stream picks its factor when it runs
+    for(auto* stream : band_streams) stream->oversampler.set_mode(oversampling_mode);
+    
+    for(auto* state : channels) {
+        for(auto& stream : state->streams) stream.oversampler.set_mode(oversampling_mode);
+    }
+}
+
+int MonoDistortion::get_num_stages(float frequency) const {
+    // The upper of the two polynomials we mix is one order up
+    float highest_harmonic = frequency * (highest_order + 1.0f);
+    
+    // ADAA already suppresses most of the aliasing, so 2x is enough on top of it when every voice uses it
+    bool anti_aliased = std::all_of(voices.begin(), voices.end(), [](const Voice& voice) {
+        return voice.is_silent() || voice.adaa_order > 0;
+    });
+    
+    int max_stages = anti_aliased ? std::min(oversampling_stages, 1) : oversampling_stages;
+    
+    int stages = 0;
+    while(stages < max_stages && highest_harmonic > sample_rate * (1 << stages) / 2) {
+        stages++;
+    }
+    
+    return stages;
+}
+
+void MonoDistortion::set_stream_frequency(ShaperStream& stream, float frequency) {
+    int factor = stream.oversampler.get_factor();
+    stream.oversampler.set_num_stages(get_num_stages(frequency));
+    
+    // The ADAA history holds inputs at the rate the stream ran at before
+    // Restart it from the last input, so the divided differences don't see a jump
+    if(stream.oversampler.get_factor() != factor) {
+        for(auto& history : stream.adaa_history) history = {history[0], history[0]};
+    }
+    
+    int delay = get_oversampling_latency() - roundToInt(stream.oversampler.get_latency_in_samples());
+    jassert(delay >= 0 && delay < ShaperStream::max_alignment);
+    
+    stream.alignment.setDelay(std::max(delay, 0));
+}
+
+void MonoDistortion::receive_message(const Identifier& id, float value, int idx)  {
+    
+    auto& voice = voices[std::clamp(idx, 0, max_voices - 1)];
+    if(id == Identifier("X")) {
+        float harmonic = value * 8.1 + 0.12;
+        voice.order.set_target(harmonic);
     }
     else if(id == Identifier("Y")) {
-        amp = 1.0f - value;
-        //smoothed_scaling.setTargetValue(new_gain);
-        //scaling = new_gain;
+        voice.amplitude.set_target(1.0f - value);
+    }
+    else if(id == Identifier("ADAA")) {
+        // The history of each stream is kept up to date for all voices, so this can switch at any time
+        voice.adaa_order = std::clamp((int)value, 0, 2);
     }
     else if(id == Identifier("Disharmonic")) {
         disharmonic = value;
     }
     else if(id == Identifier("Kind")) {
-        poly = value;
+        if((bool)value != poly) {
+            poly = value;
+            
+            // Both modes keep their own history, the one that takes over starts from silence
+            reset();
+        }
+    }
+    else if(id == Identifier("MidSide")) {
+        mid_side = value;
+    }
+    else if(id == Identifier("LinkedAnalysis")) {
+        if((bool)value != linked_analysis) {
+            linked_analysis = value;
+            
+            // The first analysis switches between the mid signal and a channel, start it over
+            for(auto* analysis : analyses) analysis->reset();
+            std::fill(linked_peak.begin(), linked_peak.end(), 0.0f);
+            generation++;
+            
+            scheduler.set_num_slices(get_num_slices());
+        }
+    }
+    else if(id == Identifier("BackgroundAnalysis")) {
+        background_analysis = value;
     }
     else if(id == Identifier("Volume")) {
-        compression_amt = value;
+        compression_amt.set_target(value);
+    }
+    else if(id == Identifier("ModDepth") || id == Identifier("ModSettings") || id == Identifier("ModShape") || id == Identifier("ModRate") || id == Identifier("ModStereoPhase")) {
+        lfo_bank.receive_message(id, value, idx);
     }
     else if(id == Identifier("MinFreq")) {
         int new_value = jmap<float>(value, 20, 110);
@@ -91,6 +389,9 @@ void MonoDistortion::receive_message(const Identifier& id, float value, int idx)
     else if(id == Identifier("Intermodulation")) {
         chroma_filter.set_density(2 - value);
     }
+    else if(id == Identifier("ChromaSelection")) {
+        chroma_filter.set_chroma_selection(value);
+    }
     /*
      
      else if(id == Identifier("Kind")) {
@@ -133,352 +434,550 @@ void MonoDistortion::receive_message(const Identifier& id, float value, int idx)
      */
 }
 
-void MonoDistortion::mute(int idx)
+void MonoDistortion::get_telemetry(TelemetryFrame& frame) const
+{
+    frame.num_bands = std::min(num_chroma_bands, TelemetryFrame::max_bands);
+    
+    if(is_linked()) {
+        std::copy(linked_peak.begin(), linked_peak.begin() + frame.num_bands, frame.band_levels.begin());
+    }
+    else {
+        // Show the louder channel for each band
+        std::fill(frame.band_levels.begin(), frame.band_levels.begin() + frame.num_bands, 0.0f);
+        for(auto* state : channels) {
+            for(int band = 0; band < frame.num_bands; band++) {
+                frame.band_levels[band] = std::max(frame.band_levels[band], state->poly_filtered_peak[band]);
+            }
+        }
+    }
+    
+    std::copy(chroma_energy.begin(), chroma_energy.begin() + frame.num_bands, frame.chroma_energies.begin());
+    
+    auto& pitch_classes = chromagram.getChromagram();
+    std::copy(pitch_classes.begin(), pitch_classes.end(), frame.pitch_classes.begin());
+    
+    // Pitch is only tracked in mono mode
+    frame.pitch = poly ? 0.0f : analyses.getFirst()->last_pitch;
+    frame.pitch_confidence = poly ? 0.0f : analyses.getFirst()->confidence;
+}
+
+void MonoDistortion::add_voice()
+{
+    lfo_bank.add_voice();
+}
+
+void MonoDistortion::remove_voice(int idx)
+{
+    if(idx < 0 || idx >= max_voices) return;
+    
+    std::rotate(voices.begin() + idx, voices.begin() + idx + 1, voices.end());
+    std::rotate(modulation.begin() + idx, modulation.begin() + idx + 1, modulation.end());
+    
+    voices.back().amplitude.set_target(0.0f);
+    
+    lfo_bank.remove_voice(idx);
+}
+
+void MonoDistortion::clear_voices()
 {
-    harmonics[idx] = {0, 0, 0};
+    for(auto& voice : voices) voice.amplitude.set_target(0.0f);
+    
+    lfo_bank.clear();
 }
 
+void MonoDistortion::mid_side_butterfly(AudioBlock<float>& block, float scale) {
+    auto* left = block.getChannelPointer(0);
+    auto* right = block.getChannelPointer(1);
+    
+    for(size_t n = 0; n < block.getNumSamples(); n++) {
+        float sum = left[n] + right[n];
+        float difference = left[n] - right[n];
+        
+        left[n] = sum * scale;
+        right[n] = difference * scale;
+    }
+}
 
-void MonoDistortion::process(Samples channel, Samples& output) {
+void MonoDistortion::process(AudioBlock<float>& block, const TransportState& new_transport) {
+    host_transport = new_transport;
+    transport_jumped |= new_transport.jumped;
     
-    // TODO: fix for blocks that are too small!
-    int num_blocks = (int)channel.size() / block_size;
+    int num_channels = std::min<int>((int)block.getNumChannels(), channels.size());
+    int num_samples = (int)block.getNumSamples();
     
-    bool output_satisfied = false;
+    bool use_mid_side = mid_side && num_channels == 2;
     
-    if(samples_ready >= channel.size()) {
-        samples_ready -= channel.size();
-        std::copy(future_buffer.begin(), future_buffer.begin(), output.begin());
-        std::copy(future_buffer.begin() + channel.size(), future_buffer.end(), future_buffer.begin());
-        output_satisfied = true;
+    // Starting or stopping the chromagram drops what it heard before, it would be out of date by the time it's used again
+    bool needs_chromagram = chroma_filter.get_chroma_selection() > 0 || telemetry_active;
+    if(needs_chromagram != chromagram_active) {
+        chromagram_active = needs_chromagram;
+        chromagram.reset();
     }
     
+    if(use_mid_side) mid_side_butterfly(block, 0.5f);
+    
+    if(!poly) {
+        host_block_start = scheduler.get_position();
+        scheduler.process(block);
+        
+        if(use_mid_side) mid_side_butterfly(block, 1.0f);
+        return;
+    }
     
-    for(int n = 0; n < channel.size(); n++) {
-        input_buffer[fifo_idx] = channel[n];
-        fifo_idx++;
+    // Swap input for output two blocks later: whenever a block is full it gets rendered,
+    // a slice at a time while the next one comes in
+    for(int done = 0; done < num_samples;) {
+        int num_to_copy = std::min(num_samples - done, block_size - fifo_idx);
+        
+        for(int ch = 0; ch < num_channels; ch++) {
+            auto* data = block.getChannelPointer(ch) + done;
+            auto& state = *channels[ch];
+            
+            std::copy(data, data + num_to_copy, state.input_buffer.begin() + fifo_idx);
+            std::copy(state.output_buffer.begin() + fifo_idx, state.output_buffer.begin() + fifo_idx + num_to_copy, data);
+        }
         
-        // Just create circular input and output buffers...
+        fifo_idx += num_to_copy;
+        done += num_to_copy;
         
-        if(fifo_idx >= block_size) {
-            fifo_idx -= block_size;
+        if(fifo_idx == block_size) {
+            fifo_idx = 0;
             
-            auto out_samples = Samples(block_size);
+            // The block before is due now
+            poly_executor.finish();
             
-            if(poly) {
-                process_poly(input_buffer, out_samples);
-            }
-            else {
-                process_block(input_buffer, out_samples);
-            }
+            // The block that was just completed started block_size samples ago, its modulation follows the song from there
+            follow_transport(done - block_size, block_size);
             
-            if(output_satisfied) {
-                std::copy(out_samples.begin(), out_samples.end(), future_buffer.begin() + samples_ready);
-                
-                samples_ready += out_samples.size();
+            for(auto* state : channels) {
+                std::swap(state->input_buffer, state->last_input);
+                std::swap(state->output_buffer, state->next_output);
+                std::fill(state->next_output.begin(), state->next_output.end(), 0.0f);
             }
-            else {
-                
+            
+            poly_executor.start(2 + chroma_filter.get_num_bands());
+        }
+        else {
+            poly_executor.advance(fifo_idx, block_size);
+        }
+    }
+    
+    if(use_mid_side) mid_side_butterfly(block, 1.0f);
+}
 
-                std::copy(out_samples.begin(), out_samples.begin() + output.size(), output.begin());
-                
+void MonoDistortion::run_poly_slice(int slice)
+{
+    if(slice > 1) {
+        {
+            ZIRCON_PROFILE_SCOPE(chroma_filter);
+            chroma_filter.process_band(slice - 2);
+        }
+        
+        shape_band(slice - 2);
+        return;
+    }
+    
+    std::array<const float*, GammatoneFilter::max_channels> inputs;
+    for(int ch = 0; ch < channels.size(); ch++) inputs[ch] = channels[ch]->last_input.data();
+    
+    // The chromagram interval is a block, so the completed block gives exactly one new chroma vector
+    if(slice == 0) {
+        update_chromagram(inputs.data(), get_num_chroma_inputs(), block_size);
+        return;
+    }
+    
+    // With chroma selection on, the latest chromagram picks the bands for this block
+    chroma_filter.set_pitch_classes(chromagram.getChromagram());
+    chroma_filter.begin_block(inputs.data(), block_size);
+    
+    // The ramps cover the whole block, every band reads the same ones
+    advance_parameters(block_size);
+    
+    num_chroma_bands = std::min<int>(chroma_filter.get_num_bands(), (int)chroma_energy.size());
+}
+
+void MonoDistortion::shape_band(int peak)
+{
+    ZIRCON_PROFILE_SCOPE(poly_waveshaper);
+    
+    auto& filtered = chroma_filter.get_output();
+    
+    int num_channels = channels.size();
+    bool linked = is_linked();
+    
+    // The band range can change while a block is in flight
+    if(peak >= (int)filtered[0].size() || peak >= (int)linked_peak.size()) return;
+    
+    // Sleeping bands are silent: only let the peak followers release, in one step
+    if(!chroma_filter.is_band_active(peak)) {
+        float release = std::pow(peak_release_scalar, (float)block_size);
+        
+        linked_peak[peak] = std::max(linked_peak[peak] * release, 1e-8f);
+        for(auto* state : channels) {
+            state->poly_filtered_peak[peak] = std::max(state->poly_filtered_peak[peak] * release, 1e-8f);
+        }
+        
+        // The oversampler would hand out what it held when the band wakes up
+        band_streams[peak]->reset();
+        
+        if(peak < num_chroma_bands) chroma_energy[peak] = 0.0f;
+        return;
+    }
+    
+    auto& stream = *band_streams[peak];
+    set_stream_frequency(stream, chroma_filter.get_band_frequency(peak));
+    
+    float energy = 0.0f;
+    
+    // The bands are linear, so the band of the mid signal is the average of the channels' bands
+    // All channels get compressed by the envelope of the mid signal, calculate that first
+    if(linked) {
+        for(int n = 0; n < block_size; n++) {
+            float mid = 0.0f;
+            for(int ch = 0; ch < num_channels; ch++) mid += filtered[ch][peak][n];
+            mid /= num_channels;
+            
+            energy += mid * mid;
+            
+            linked_peak[peak] *= peak_release_scalar;
+            linked_peak[peak] = std::max({linked_peak[peak], abs(mid), 1e-8f});
+            
+            shaper_gain[n] = jmap(jmap(compression_amt.get(n), 0.95f, 1.0f), 1.0f, std::max(linked_peak[peak], 1e-5f));
+        }
+    }
+    
+    for(int ch = 0; ch < num_channels; ch++) {
+        auto& state = *channels[ch];
+        auto& band = filtered[ch][peak];
+        
+        for(int n = 0; n < block_size; n++) {
+            float filter_out = band[n];
+            
+            if(!linked) {
+                energy += filter_out * filter_out / num_channels;
                 
-                std::copy(out_samples.begin() + output.size(), out_samples.end(), future_buffer.begin() + samples_ready);
+                state.poly_filtered_peak[peak] *= peak_release_scalar;
+                state.poly_filtered_peak[peak] = std::max({state.poly_filtered_peak[peak], abs(filter_out), 1e-8f});
                 
-                samples_ready += out_samples.size() - output.size();
+                shaper_gain[n] = jmap(jmap(compression_amt.get(n), 0.95f, 1.0f), 1.0f, std::max(state.poly_filtered_peak[peak], 1e-5f));
             }
             
-            
+            shaper_input[n] = std::clamp(filter_out / shaper_gain[n], -1.0f, 1.0f);
+        }
+        
+        shape_stream(stream, ch, ch, 0, block_size, true);
+        
+        if(oversampling_stages > 0) {
+            for(int n = 0; n < block_size; n++) {
+                stream.alignment.pushSample(ch, shaper_output[n]);
+                shaper_output[n] = stream.alignment.popSample(ch);
+            }
         }
+        
+        FloatVectorOperations::add(state.next_output.data(), shaper_output.data(), block_size);
+    }
+    
+    if(peak < num_chroma_bands) {
+        chroma_energy[peak] = energy / block_size;
     }
 }
 
-void MonoDistortion::process_poly(Samples channel, Samples& output)
+void MonoDistortion::shape_stream(ShaperStream& stream, int stream_channel, int channel, int position, int num_samples, bool follow_ramps)
 {
-    //auto fft = dsp::FFT(11);
+    auto& oversampler = stream.oversampler;
+    
+    int factor = oversampler.get_factor();
+    int oversampled_samples = num_samples * factor;
+    
+    oversampler.upsample(stream_channel, shaper_input.data(), oversampled_input.data(), oversampled_angle.data(), num_samples);
     
-    auto filtered = chroma_filter.process(channel);
+    // The upsampling filters overshoot, so clamp again
+    for(int i = 0; i < oversampled_samples; i++) {
+        oversampled_input[i] = std::clamp(oversampled_input[i], -1.0f, 1.0f);
+        oversampled_angle[i] = acos(oversampled_input[i]);
+    }
+    
+    auto& history = stream.adaa_history[stream_channel];
+    
+    std::fill(oversampled_output.begin(), oversampled_output.begin() + oversampled_samples, 0.0f);
+    shape_voices(oversampled_input.data(), oversampled_angle.data(), history, oversampled_output.data(), num_samples, factor, channel, position, follow_ramps);
+    
+    history = {oversampled_input[oversampled_samples - 1], oversampled_input[oversampled_samples - 2]};
+    
+    // The compression follows the envelope, holding it is good enough
+    for(int n = 0; n < num_samples; n++) {
+        FloatVectorOperations::multiply(oversampled_output.data() + n * factor, shaper_gain[n], factor);
+    }
     
+    oversampler.downsample(stream_channel, oversampled_output.data(), shaper_output.data(), num_samples);
+}
+
+void MonoDistortion::shape_voices(const float* input, const float* angle, const std::array<float, 2>& history, float* output, int num_samples, int factor, int channel, int position, bool follow_ramps)
+{
+    using namespace ChebyshevPolynomials;
     
-    for(int peak = 0; peak < filtered.size(); peak++) {
-        for(int n = 0; n < filtered[peak].size(); n++) {
-            float filter_out = filtered[peak][n];
+    for(int v = 0; v < max_voices; v++) {
+        auto& voice = voices[v];
+        if(voice.is_silent()) continue;
+        
+        auto& voice_modulation = modulation[v][channel];
+        
+        // ADAA delays the voice by half a sample (first order) or a sample (second order) at the rate the stream runs at
+        // That's not compensated: it's less than a base rate sample, and each voice adds different harmonics anyway
+        double x1 = history[0], x2 = history[1];
+        
+        for(int n = 0; n < num_samples; n++) {
+            float order = follow_ramps ? voice.order.get(position + n) : voice.order.get_current();
+            float amplitude = follow_ramps ? voice.amplitude.get(position + n) : voice.amplitude.get_current();
             
-            poly_filtered_peak[peak] *= peak_release_scalar;
-            poly_filtered_peak[peak] = std::max({poly_filtered_peak[peak], abs(filter_out), 1e-8f});
+            float harmonic = std::max(order + voice_modulation[position + n], 0.0f);
             
-            for(auto& [harmonic, amplitude, phase] : harmonics) {
-                if(harmonic == 0 || amplitude == 0) continue;
-                
-                int lower = harmonic;
-                int upper = lower + 1;
-                
-                float mix = harmonic - (int)harmonic;
-                
-                float offset_1 = (lower - 1 & 1) - (((lower & 3) == 0) * 2);
-                float offset_2 = (upper - 1 & 1) - (((upper & 3) == 0) * 2);
-                
-                float compression = jmap(jmap(compression_amt, 0.95f, 1.0f), 1.0f, std::max(poly_filtered_peak[peak], 1e-5f));
-                
-                
-                float in_value = acos(std::clamp(filter_out / compression, -1.0f, 1.0f));
-                
-                
-                float out_1 = (cos(in_value * (float)lower) + offset_1) * compression * amplitude;
-                float out_2 = (cos(in_value * (float)upper) + offset_2) * compression * amplitude;
+            // The antiderivatives are only tabulated up to the highest order
+            if(voice.adaa_order) harmonic = std::min(harmonic, (float)(num_polynomials - 2));
+            
+            int lower = harmonic;
+            int upper = lower + 1;
+            
+            float mix = harmonic - (int)harmonic;
+            
+            float offset_1 = (lower - 1 & 1) - (((lower & 3) == 0) * 2);
+            float offset_2 = (upper - 1 & 1) - (((upper & 3) == 0) * 2);
+            
+            // The order and amplitude are slow control signals, so they're held for the oversampled samples
+            if(!voice.adaa_order) {
+                for(int i = n * factor; i < (n + 1) * factor; i++) {
+                    float out_1 = (cos(angle[i] * (float)lower) + offset_1) * amplitude;
+                    float out_2 = (cos(angle[i] * (float)upper) + offset_2) * amplitude;
+                    
+                    output[i] += jmap(mix, out_1, out_2);
+                }
+                continue;
+            }
+            
+            for(int i = n * factor; i < (n + 1) * factor; i++) {
+                double x0 = input[i];
                 
-                /*
-                 float out_1 = ChebyshevFactory::second_tables[lower].processSample(in_value) * compression * amplitude;
-                 
-                 float out_2 = ChebyshevFactory::second_tables[upper].processSample(in_value) * compression * amplitude;
-                 */
+                double out_1, out_2;
+                if(voice.adaa_order == 1) {
+                    out_1 = evaluate_first_order_adaa(lower, x0, x1);
+                    out_2 = evaluate_first_order_adaa(upper, x0, x1);
+                }
+                else {
+                    out_1 = evaluate_second_order_adaa(lower, x0, x1, x2);
+                    out_2 = evaluate_second_order_adaa(upper, x0, x1, x2);
+                }
                 
-                output[n] += jmap(mix, out_1, out_2);
+                output[i] += jmap<double>(mix, out_1, out_2) * amplitude;
                 
+                x2 = x1;
+                x1 = x0;
             }
-                    
-                   
         }
     }
+}
+
+int MonoDistortion::get_num_slices() const {
+    int num_analyses = is_linked() ? 1 : channels.size();
+    return 1 + num_analyses + channels.size() * slices_per_window;
+}
+
+void MonoDistortion::run_slice(int slice) {
+    bool linked = is_linked();
+    int num_analyses = linked ? 1 : channels.size();
+    
+    // Mono mode moves the parameters once per hop
+    // The newest hop of LFOs lines up with the input that the end of this hop's window reads
+    if(slice == 0) {
+        follow_transport((int)(scheduler.get_hop_end() - host_block_start) - render_delay - step, step);
+        advance_parameters(step);
+        
+        // Every other hop calculates a chroma vector
+        if(chromagram_active) {
+            read_signal(get_num_chroma_inputs() == 1 ? 0 : all_channels, 0, hop_buffer.data(), step);
+            
+            const float* input = hop_buffer.data();
+            update_chromagram(&input, 1, step);
+        }
+        return;
+    }
+    
+    slice -= 1;
     
+    if(slice < num_analyses) {
+        analyse(slice);
+        return;
+    }
     
+    slice -= num_analyses;
     
+    int ch = slice / slices_per_window;
+    int start = (slice % slices_per_window) * slice_size;
+    
+    render(*channels[ch], *analyses[linked ? 0 : ch], ch, start, start + slice_size);
 }
 
-void MonoDistortion::process_block(Samples channel, Samples& output) {
-    
-    audio_thread = Thread::getCurrentThread();
+void MonoDistortion::read_signal(int channel, int delay, float* destination, int num_samples) {
+    if(channel != all_channels) {
+        scheduler.read_input(channel, delay, destination, num_samples);
+        return;
+    }
     
-    std::vector<std::complex<float>> hilbert_output(channel.size());
-    auto phase_block = Samples(channel.size());
+    // Mid is the average of all channels
+    scheduler.read_input(0, delay, destination, num_samples);
+    for(int ch = 1; ch < channels.size(); ch++) {
+        scheduler.read_input(ch, delay, mid_buffer.data(), num_samples);
+        FloatVectorOperations::add(destination, mid_buffer.data(), num_samples);
+    }
+    FloatVectorOperations::multiply(destination, 1.0f / channels.size(), num_samples);
+}
+
+void MonoDistortion::update_chromagram(const float* const* inputs, int num_inputs, int num_samples) {
+    if(!chromagram_active) return;
     
-    //downsample_filter.processSamples(channel.data(), (int)channel.size());
+    ZIRCON_PROFILE_SCOPE(chromagram);
+    chromagram.processAudioFrame(inputs, num_inputs, num_samples);
+}
+
+void MonoDistortion::analyse(int index) {
+    auto& analysis = *analyses[index];
+    auto& amplitude = analysis.amplitude;
     
-    hilbert.process(channel, hilbert_output);
+    int channel = is_linked() ? all_channels : index;
     
-    // First get amplitude information
-    auto amp_channel = channel;
-    for (int i = 0; i < amp_channel.size(); i++)
+    // Envelope of the newest hop
     {
-        peak_amp *= peak_release_scalar;
-        peak_amp = std::max({peak_amp, abs(hilbert_output[i]), 1e-7f});
-        amp_channel[i] = peak_amp;
-        phase_block[i] = (arg(hilbert_output[i]) / (2.0 * M_PI)) + 0.5;
-    }
-    
-    // Then get raw pitch information
-    for(int n = 0; n < channel.size(); n += step) {
-        for(int i = 0; i < block_size; i++) {
-            int idx = jmap(i, 0, block_size,  n - block_size,  n);
-            block[i] = idx < 0 ?  history[idx + block_size] : channel[idx];
-            block[i] /= idx < 0 ?  amp_history[idx + block_size] : amp_channel[idx];
-        }
+        ZIRCON_PROFILE_SCOPE(hilbert);
         
-        float frequency = pya.probabilistic_pitch(block, 44100.0f);
-        //float frequency = pitch::swipe<float>(block, sample_rate);
+        read_signal(channel, 0, hop_buffer.data(), step);
+        analysis.hilbert.process(hop_buffer, hilbert_output);
         
-        if(!std::isfinite(frequency) || frequency == -1) frequency = 0.0f;
-        
-        for(int s = 0; s < step; s++) {
-            freq_buffer[n + s] = frequency;
-        }
+        std::copy(amplitude.begin() + step, amplitude.end(), amplitude.begin());
         
         for(int i = 0; i < step; i++) {
-            amp_delay_line.push_back(channel[n + i]);
-            channel[n + i] = amp_delay_line[0];
-            amp_delay_line.pop_front();
+            analysis.peak_amp *= peak_release_scalar;
+            analysis.peak_amp = std::max({analysis.peak_amp, abs(hilbert_output[i]), 1e-7f});
+            amplitude[block_size - step + i] = analysis.peak_amp;
         }
-        
     }
     
-    for(int i = 0; i < step; i++) {
-        output[i] += out_history[i];
-    }
+    // Then the pitch of the block that ends analysis_delay samples ago, normalised by the envelope ahead of it
+    ZIRCON_PROFILE_SCOPE(pitch_tracking);
     
-    for(int n = 0; n < freq_buffer.size(); n += step) {
-        
-        for(int i = 0; i < block_size; i++) {
-            int idx = jmap(i, 0, block_size,  n - block_size,  n);
-            block[i] = idx < 0 ?  history[idx + block_size] : channel[idx];
-        }
+    read_signal(channel, analysis_delay, block.data(), block_size);
+    
+    if(background_analysis && analysis_thread.is_enabled() && analyse_in_background(analysis, index)) return;
+    
+    FloatVectorOperations::divide(block.data(), block.data(), amplitude.data(), block_size);
+    
+    float frequency = analysis.pya.probabilistic_pitch(block, 44100.0f);
+    
+    if(!std::isfinite(frequency) || frequency == -1) frequency = 0.0f;
+    
+    analysis.frequency = frequency;
+    analysis.last_pitch = frequency;
+    analysis.confidence = analysis.pya.confidence;
+}
+
+bool MonoDistortion::analyse_in_background(Analysis& analysis, int index) {
+    int64 hop = scheduler.get_hop_count();
+    
+    // A full ring means the thread is behind already, the watchdog takes care of that
+    if(auto* frame = analysis_thread.get_free_frame()) {
+        frame->stream = index;
+        frame->hop = hop;
+        frame->generation = generation;
         
-        float frequency = freq_buffer[n];
+        std::copy(block.begin(), block.end(), frame->signal.begin());
+        std::copy(analysis.amplitude.begin(), analysis.amplitude.end(), frame->amplitude.begin());
         
-        int window_idx = n / step;
+        frame->first_note = chroma_filter.start;
+        frame->band_step = chroma_filter.skip_size;
+        frame->num_bands = chroma_filter.get_num_bands();
         
-        for(auto& filter : svf[window_idx]) {
-            filter.setCutoffFrequency(std::max(frequency, 80.0f));
-        }
+        analysis_thread.push();
+    }
     
-        for(auto& [harmonic, amplitude, phase] : harmonics) {
-            if(harmonic == 0 || amplitude == 0) continue;
-            
-            for(int i = 0; i < block_size; i++) {
-                
-                float filter_out = block[i];
-                
-                for(auto& filter : svf[window_idx]) filter_out = filter.processSample(0, filter_out);
-                
-                filtered_peak *= peak_release_scalar;
-                filtered_peak = std::max({filtered_peak, abs(filter_out), 1e-8f});
-                
-                
-                int lower = harmonic;
-                int upper = lower + 1;
-                
-                float mix = harmonic - (int)harmonic;
-                
-                float offset_1 = (lower - 1 & 1) - (((lower & 3) == 0) * 2);
-                float offset_2 = (upper - 1 & 1) - (((upper & 3) == 0) * 2);
-
-                float compression = jmap(jmap(compression_amt, 0.95f, 1.0f), 1.0f, std::max(filtered_peak, 1e-5f));
-                
-                
-                float in_value = acos(std::clamp(filter_out / compression, -1.0f, 1.0f));
-
-                
-                float out_1 = (cos(in_value * (float)lower) + offset_1) * compression * amplitude;
-                float out_2 = (cos(in_value * (float)upper) + offset_2) * compression * amplitude;
+    collect_results();
+    
+    auto& estimate = analysis.estimates[(hop - look_behind) & 3];
+    
+    if(estimate.hop == hop - look_behind) {
+        analysis.missed_hops = 0;
+        analysis.frequency = analysis.last_pitch = estimate.pitch;
+        analysis.confidence = estimate.confidence;
+        return true;
+    }
+    
+    // Late: hold the last pitch for a while
+    return ++analysis.missed_hops < watchdog_hops;
+}
 
-                current_window[i] = jmap(mix, out_1, out_2) * 2.0f;
-                
-                
-                //std::cout << filtered_peak << std::endl;
-                
-            }
-        }
+void MonoDistortion::collect_results() {
+    AnalysisThread::Result result;
+    
+    while(analysis_thread.pop(result)) {
+        if(result.generation != generation || result.stream >= analyses.size()) continue;
         
-        apply_window(current_window, hanning_window);
+        auto& analysis = *analyses[result.stream];
+        analysis.estimates[result.hop & 3] = {result.hop, result.pitch, result.confidence};
         
+        // The telemetry shows the first analysis, like the pitch
+        if(result.stream == 0) {
+            num_chroma_bands = std::min<int>(result.num_bands, (int)chroma_energy.size());
+            std::copy(result.band_energies.begin(), result.band_energies.begin() + num_chroma_bands, chroma_energy.begin());
+        }
+    }
+}
+
+void MonoDistortion::render(ChannelState& state, const Analysis& analysis, int channel, int start, int end) {
+    ZIRCON_PROFILE_SCOPE(mono_waveshaper);
+    
+    // Overlapping windows each have their own filters and oversampling
+    auto& filters = state.svf[scheduler.get_hop_count() & 1];
+    auto& stream = state.streams[scheduler.get_hop_count() & 1];
+    
+    if(start == 0) {
+        scheduler.read_input(channel, render_delay, state.frame.data(), block_size);
+        std::fill(state.window.begin(), state.window.end(), 0.0f);
         
-        for(int i = 0; i < block_size; i++) {
-            int idx = n + i;
-            
-            if(idx >= block_size) {
-                out_history[idx - block_size] = current_window[i];
-            }
-            else {
-                output[idx] += current_window[i];
-            }
+        for(auto& filter : filters) {
+            filter.setCutoffFrequency(std::max(analysis.frequency, 80.0f));
         }
         
+        // The factor stays the same for the whole window
+        set_stream_frequency(stream, std::max(analysis.frequency, 80.0f));
         
-        for(int i = 0; i < step; i++) {
-            delay_line.push_back(channel[n + i]);
-            channel[n + i] = delay_line[0];
-            delay_line.pop_front();
-        }
+        last_frequency = analysis.frequency;
+    }
+    
+    int num_samples = end - start;
+    
+    for(int i = start; i < end; i++) {
+        float filter_out = state.frame[i];
         
-        for(int i = 0; i < step; i++) {
-            //output[n + i] += channel[n + i];
-        }
+        for(auto& filter : filters) filter_out = filter.processSample(0, filter_out);
         
+        state.filtered_peak *= peak_release_scalar;
+        state.filtered_peak = std::max({state.filtered_peak, abs(filter_out), 1e-8f});
         
-        /*
-         if(n % step == 0)  {
-         averager.add(frequency);
-         delta_average.add((delta < 1.0f && delta) ? (1.0f / delta) : delta);
-         }
-         
-         
-         // Transient detection
-         float amp_delta = abs(amp_channel[n > 0 ? n - 1 : 0] - amp_channel[n]) * 140.0f;
-         float freq_delta = delta_average.avg();
-         
-         // TODO: experiment with weighting these conditions
-         bool out_of_range = frequency > 1000 || frequency < 50;
-         bool wobbly = freq_delta > 1.25;
-         bool divergent = (diff > 2.5f || 1.0f / diff < 2.5f) && avg;
-         
-         if(out_of_range || wobbly) {
-         amp_delta += 1.0f;
-         } */
-        
-        
-        /*
-         for(auto& [harmonic, amplitude, phase] : harmonics) {
-         if(harmonic == 0 || amplitude == 0) continue;
-         
-         int closest_harmonic = round(harmonic);
-         
-         while(phase > 1.0f) phase -= 1.0f;
-         while(phase < 0.0f) phase += 1.0f;
-         
-         int offset = (closest_harmonic - 1 & 1) - (((closest_harmonic & 3) == 0) * 2);
-         
-         float distortion = (offset + cos(acos(tanh(delayed / delayed_amp)) * (float)closest_harmonic)) * amplitude * delayed_amp;
-         
-         
-         
-         float mix = harmonic - (int)harmonic;
-         //distorted += isfinite(distortion) ? distortion : 0.0f;
-         
-         if(disharmonic) {
-         //distorted += hilbert_output[n].real() * sin(phase * 2.0 * M_PI) + hilbert_output[n].imag() * cos(phase * 2.0 * M_PI);
-         distorted = delayed;
-         //distorted += cos(disharmonic_block.getSample(0, n) * 2.0 * M_PI) * abs(hilbert_output[n]);
-         
-         phase += (frequency * harmonic) / sample_rate;
-         
-         sine += cos(phase * M_PI * 2.0f) * delayed_amp * amplitude * 3.0f;
-         
-         }
-         else {
-         
-         distorted = delayed;
-         
-         int rounded = harmonic;
-         
-         float out_1 = cos(phase * M_PI * 2.0f * (float)rounded) * delayed_amp * amplitude * 3.0f;
-         float out_2 = cos(phase * M_PI * 2.0f * ((float)rounded + 1.0f)) * delayed_amp * amplitude * 3.0f;
-         
-         float filter_out = delayed * delayed_amp;
-         
-         for(auto& filter : svf) filter_out = filter.processSample(0, filter_out);
-         
-         filtered_peak *= peak_release_scalar;
-         filtered_peak = std::max({filtered_peak, abs(filter_out), 1e-8f});
-         
-         sine += cos(acos(filter_out / filtered_peak) * (float)closest_harmonic) * filtered_peak; //jmap(mix, out_1, out_2);
-         
-         phase += frequency / sample_rate;
-         
-         }
-         
-         
-         
-         //if(!std::isfinite(sine)) sine = 0.0f;
-         //sine = std::clamp(sine, -1.0f, 1.0f);
-         
-         
-         
-         //distorted += tanh((delayed / delayed_amp) * 2.0f);
-         
-         
-         //if(!(closest_harmonic & 1)) distorted *= 2.0f;
-         
-         
-         }*/
-        
-        // TODO:: apply filter on sine
-        
-        //sine /= harmonics.size();
-        
-        //output[n] = jmap<float>(transient, sine, distorted);
-        //output[n] = distorted + (sine * (1.0f - transient));
-        // + distorted;
-        //output[n] = transient;
-        //output[n] = jmap<float>(transient, sine, 0.0f);
-        
-        
-        
-        last_frequency = frequency;
-        
-        
-    }
-    
-    //std::copy(output.begin(), output.end(), out_history.begin());
-    std::copy(channel.begin(), channel.end(), history.begin());
-    std::copy(amp_channel.begin(), amp_channel.end(), amp_history.begin());
+        float compression = jmap(jmap(compression_amt.get_current(), 0.95f, 1.0f), 1.0f, std::max(state.filtered_peak, 1e-5f));
+        
+        shaper_gain[i - start] = compression;
+        shaper_input[i - start] = std::clamp(filter_out / compression, -1.0f, 1.0f);
+    }
+    
+    // Overlapping windows cross-fade, so holding the smoothed values for a window is enough
+    // The LFOs move faster than that, the window follows them over both hops it covers
+    shape_stream(stream, 0, channel, start, num_samples, false);
+    
+    if(oversampling_stages > 0) {
+        for(int i = 0; i < num_samples; i++) {
+            stream.alignment.pushSample(0, shaper_output[i]);
+            shaper_output[i] = stream.alignment.popSample(0);
+        }
+    }
+    
+    FloatVectorOperations::addWithMultiply(state.window.data() + start, shaper_output.data(), 2.0f, num_samples);
     
+    if(end == block_size) scheduler.add_frame(channel, state.window.data());
 }
@@ -7,13 +7,21 @@
 
 #include "MovingAverage.hpp"
 #include "Hilbert.hpp"
-#include "Rate.hpp"
 
 #include "PitchDetection/pitch_detection.h"
 #include "DynamicFilter.hpp"
 #include "ChromaFilter.hpp"
+#include "Chroma/Chromagram.h"
 
 #include "ChebyshevTable.hpp"
+#include "HalfbandOversampler.hpp"
+#include "Telemetry.hpp"
+#include "Profiler.hpp"
+#include "OverlapAdd.hpp"
+#include "SliceExecutor.hpp"
+#include "AnalysisThread.hpp"
+#include "BlockSmoother.hpp"
+#include "LFOBank.hpp"
 
 #include <JuceHeader.h>
 
@@ -21,7 +29,6 @@
 #include <iostream>
 #include <algorithm>
 #include <vector>
-#include <deque>
 
 using Sample = float;
 using Samples = std::vector<float>;
@@ -30,75 +37,332 @@ using Samples = std::vector<float>;
 struct MonoDistortion
 {
     
-    Thread* audio_thread = nullptr;
-        
     IIRFilter downsample_filter;
     
     MonoDistortion();
     
-    void process(Samples channel, Samples& output);
+    // Sets up the state for each channel, call before processing
+    void prepare(int num_channels);
+    
+    // Replaces each channel of the block with its distortion
+    // Poly mode collects the input into blocks of block_size and renders each one while the next comes in,
+    // so its output is get_latency() samples behind
+    // Mono mode renders a window for each hop through the overlap-add scheduler, one hop behind
+    // The synced LFOs follow the host's transport, starting at the first sample of the block
+    void process(AudioBlock<float>& block, const TransportState& new_transport);
+    
+    // Clears all history, filters and envelopes, keeps the parameters
+    void reset();
+    
+    // After the host skipped blocks: drops the poly block and the mono hop that were in flight, they belong to before the gap
+    // Filters, envelopes and parameters stay, they only hold what was below the silence threshold
+    void restart_stream();
+    
+    int get_num_channels() const { return channels.size(); }
+    
+    // Samples of output that can follow the last non-silent input
+    int get_tail_samples() const;
+    
+    // Delay of the output behind the input, depends on the mode
+    // Poly: two blocks, plus the delay that lines up the chroma bands
+    // Mono: the render delay and the window behind the end of a hop, plus the hop the scheduler holds the output back
+    // Both add the round trip through the oversampler
+    int get_latency() const;
     
     void receive_message(const Identifier& id, float value, int idx);
     
-    void mute(int idx);
+    // Streams that would alias get resampled by up to 2^num_stages, 0 turns oversampling off
+    void set_oversampling(int num_stages, HalfbandOversampler::Mode mode);
+    
+    // Starts or stops the analysis thread, call from the message thread
+    // The audio thread only starts using it after the "BackgroundAnalysis" message
+    void set_background_analysis(bool enabled) { analysis_thread.set_enabled(enabled); }
+    
+    // Voice management, follows the XY sliders like the LFO bank
+    // Removing a voice moves the ones behind it down and fades the removed one out in the last slot
+    void add_voice();
+    void remove_voice(int idx);
+    void clear_voices();
+    
+    // Copies the latest analysis state, cheap enough to call every block
+    void get_telemetry(TelemetryFrame& frame) const;
+    
+    // The chromagram only runs for chroma selection, or while something shows the telemetry
+    void set_telemetry_active(bool active) { telemetry_active = active; }
     
 
     ChromaFilter chroma_filter; // temporarily public
     
 private:
     
-    pitch_alloc::Mpm<float> pya = pitch_alloc::Mpm<float>(block_size);
-    
-    void process_block(Samples channel, Samples& output);
-    void process_poly(Samples channel, Samples& output);
-    
     static constexpr int block_size = 2048;
     static constexpr int step = 1024;
     
     static constexpr int overlap = 2;
     
+    // Mono mode: the envelope that normalises the pitch block runs analysis_delay samples ahead of it,
+    // and the rendered signal trails the pitch block by as much again
+    static constexpr int analysis_delay = 2 * block_size;
+    static constexpr int render_delay = 2 * analysis_delay;
+    
+    // Samples of a window that are rendered in one go
+    static constexpr int slice_size = 256;
+    static constexpr int slices_per_window = block_size / slice_size;
+    
+    // A new chroma vector for every poly block
+    static constexpr int chroma_hop = block_size;
+    
+    // Channel index of the mid signal
+    static constexpr int all_channels = -1;
+    
+    // Background analysis: a hop renders with the pitch of look_behind hops before it,
+    // after watchdog_hops late results in a row the pitch is tracked on the audio thread again until they're back in time
+    static constexpr int look_behind = 1;
+    static constexpr int watchdog_hops = 4;
+
+    static constexpr int max_voices = 5;
+    
+    // Parameter changes ramp over this long, in both modes
+    static constexpr float smoothing_time = 0.02f;
 
     static constexpr int avg_window_1 = 512;
     static constexpr int avg_window_2 = 64;
     
+    // Oversampling state of one waveshaper input: a chroma band in poly mode, or the windows of one parity in mono mode
+    // Each stream picks its own factor, the alignment delay lines it up with a stream at the highest factor
+    struct ShaperStream
+    {
+        void prepare(const ProcessSpec& spec);
+        void reset();
+        
+        static constexpr int max_alignment = 64;
+        
+        HalfbandOversampler oversampler;
+        dsp::DelayLine<float> alignment { max_alignment };
+        
+        // The last two shaper inputs of each channel, at the rate the stream runs at
+        std::vector<std::array<float, 2>> adaa_history;
+    };
+    
+    // Everything that follows the signal of one channel
+    struct ChannelState
+    {
+        ChannelState(float sample_rate);
+        
+        void reset();
+        
+        // Poly mode: the block that is being collected, and the rendered block that is being handed out
+        Samples input_buffer;
+        Samples output_buffer;
+        
+        // The block that was collected before, and what it's being rendered into
+        Samples last_input;
+        Samples next_output;
+        
+        // Mono mode: input and output of the window that is being rendered
+        Samples frame;
+        Samples window;
+        
+        float filtered_peak = 0.0f;
+        std::vector<float> poly_filtered_peak;
+        
+        std::array<std::array<dsp::StateVariableTPTFilter<float>, 4>, 6> svf;
+        
+        // Windows of the same parity follow each other without overlap, like their filters
+        std::array<ShaperStream, 2> streams;
+    };
+    
+    // Envelope and pitch track of one signal: a channel, or the mid signal when the analysis is linked
+    struct Analysis
+    {
+        Analysis();
+        
+        void reset();
+        
+        // Envelope of the last block_size samples, the newest hop at the end
+        Samples amplitude;
+        
+        // Pitch of the last complete hop
+        float frequency = 0.0f;
+        float confidence = 0.0f;
+        
+        // Background results of the last few hops
+        struct Estimate
+        {
+            int64 hop = -1;
+            float pitch = 0.0f;
+            float confidence = 0.0f;
+        };
+        
+        std::array<Estimate, 4> estimates;
+        int missed_hops = 0;
+        
+        float peak_amp = 0.0f;
+        float last_pitch = 0.0f;
+        
+        Hilbert hilbert;
+        pitch_alloc::Mpm<float> pya = pitch_alloc::Mpm<float>(block_size);
+    };
+    
+    // One per XY slider: the polynomial order comes from X, the amplitude from Y
+    struct Voice
+    {
+        BlockSmoother<> order, amplitude;
+        
+        // 0 is off, 1 or 2 selects the order of the antiderivative anti-aliasing
+        int adaa_order = 0;
+        
+        // Order 0 is silence too, so either one settled at zero skips the voice for the block
+        bool is_silent() const {
+            return (amplitude.is_constant() && amplitude.get_current() == 0.0f) || (order.is_constant() && order.get_current() == 0.0f);
+        }
+    };
+    
+    // Renders the parameter ramps and the LFOs for the next num_samples, shared by all bands
+    void advance_parameters(int num_samples);
+    
+    // Points the LFOs at the song position of the input sample offset samples into the host block,
+    // for the num_samples they render next
+    void follow_transport(int offset, int num_samples);
+    
+    bool is_linked() const { return linked_analysis && channels.size() > 1; }
+    
+    // Poly mode: one slice of the work for a block, the chromagram first, then setting up the chroma filter, then each band
+    void run_poly_slice(int slice);
+    void shape_band(int band);
+    
+    // Runs num_samples of shaper_input through every voice at the stream's rate, into shaper_output
+    // The output is scaled back up by shaper_gain, the compression that normalised the input
+    // Poly mode follows the parameter ramps, mono mode holds them for the window, the LFOs are read from position on
+    void shape_stream(ShaperStream& stream, int stream_channel, int channel, int position, int num_samples, bool follow_ramps);
+    
+    // Adds every voice's waveshaper to output, for the input and its arccosine at factor times the base rate
+    // Voices with ADAA read history, the inputs before this call
+    void shape_voices(const float* input, const float* angle, const std::array<float, 2>& history, float* output, int num_samples, int factor, int channel, int position, bool follow_ramps);
+    
+    // Smallest number of 2x stages that keeps the highest harmonic of a signal at frequency below nyquist,
+    // limited by the quality setting
+    int get_num_stages(float frequency) const;
+    
+    // Picks the factor for the next block of a stream, and the delay that lines it up with the highest factor
+    void set_stream_frequency(ShaperStream& stream, float frequency);
+    
+    int get_oversampling_latency() const;
+    
+    // Mono mode: one slice of the work for a hop, the parameters and the chromagram first,
+    // then the pitch of each analysis, then each channel's window
+    void run_slice(int slice);
+    int get_num_slices() const;
+    
+    // Copies input from the scheduler, for all_channels the average of the channels
+    void read_signal(int channel, int delay, float* destination, int num_samples);
+    
+    // Feeds the chromagram the average of the inputs, a hop of input calculates a new chroma vector
+    // That FFT is the expensive part of the chromagram, it only runs as a slice
+    void update_chromagram(const float* const* inputs, int num_inputs, int num_samples);
+    
+    // In mid/side mode the first channel is the mid signal, which already is the average of left and right
+    int get_num_chroma_inputs() const { return mid_side && channels.size() == 2 ? 1 : channels.size(); }
+    
+    void analyse(int index);
+    
+    // Hands the block to the analysis thread and picks up the pitch from look_behind hops ago
+    // Returns false when the watchdog wants it tracked here instead
+    bool analyse_in_background(Analysis& analysis, int index);
+    void collect_results();
+    void render(ChannelState& state, const Analysis& analysis, int channel, int start, int end);
+    
+    // Left/right to mid/side and back is the same butterfly, scaled by a half on the way in
+    static void mid_side_butterfly(AudioBlock<float>& block, float scale);
+    
+    OwnedArray<ChannelState> channels;
+    
+    OverlapAddScheduler scheduler;
+    SliceExecutor poly_executor;
+    
+    // One per channel, only the first one runs when the analysis is linked
+    OwnedArray<Analysis> analyses;
+    
     bool poly = true;
     
+    // Runs the engine on mid and side instead of left and right
+    bool mid_side = false;
+    
+    // Analyses the mid signal once and drives all channels with it, instead of analysing each channel
+    // Keeps the channels moving together, wide sources can sound better with separate analysis
+    bool linked_analysis = true;
+    
+    // Tracks the pitch on the analysis thread, if it runs
+    bool background_analysis = false;
+    AnalysisThread analysis_thread;
+    
+    // Results from before a reset are dropped
+    int generation = 0;
+    
     int min_freq = 43, max_freq = 79;
     
     
+    // Scratch space, shared by all channels
     Samples block;
-    Samples amp_channel;
-    Samples amp_history;
-    Samples freq_buffer;
-    Samples current_window;
-    Samples out_history;
+    Samples hop_buffer;
+    Samples mid_buffer;
+    std::vector<std::complex<float>> hilbert_output;
     
-    Samples input_buffer;
-    Samples future_buffer;
+    // Waveshaper input, compression and output at the base rate, and the oversampled input, its arccosine and the output
+    // The angle buffer is the upsampling scratch space until it's filled
+    Samples shaper_input, shaper_gain, shaper_output;
+    Samples oversampled_input, oversampled_angle, oversampled_output;
     
-    int fifo_idx = 0;
-    int samples_ready = 0;
+    // One per chroma band, for all channels
+    OwnedArray<ShaperStream> band_streams;
     
-    std::vector<float> history;
-    std::deque<float> delay_line;
+    int oversampling_stages = 0;
+    HalfbandOversampler::Mode oversampling_mode = HalfbandOversampler::low_latency;
     
-    std::deque<float> chroma_delay;
-    std::deque<float> amp_delay_line;
+    // Highest order any voice reaches with its modulation, over the modulation history
+    float highest_order = 0.0f;
+    
+    // Position in the current block, the same for all channels
+    int fifo_idx = 0;
         
-    std::vector<std::tuple<float, float, float>> harmonics = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    std::array<Voice, max_voices> voices;
+    
+    // Each voice's LFO is added to its order
+    LFOBank lfo_bank;
+    
+    // LFO output of the last block_size samples for each voice and channel, the newest at the end
+    // Poly mode renders a whole block at once, mono mode a hop, so a window reads the two hops it covers
+    std::array<std::vector<Samples>, max_voices> modulation;
+    
+    // Transport of the host block that is coming in, and of the input the LFOs render for next
+    TransportState host_transport, transport;
+    
+    // Scheduler position at the start of the host block
+    int64 host_block_start = 0;
+    
+    // Set when any host block jumped since the LFOs last rendered
+    bool transport_jumped = true;
     
     float sample_rate = 44100.0f;
     
-    float compression_amt = 0.5;
+    BlockSmoother<> compression_amt;
     
-    float peak_amp = 0.0f;
     float release_ms = 500.0f;
     float exp_factor = -2.0f * M_PI * 1000.0f / sample_rate;
     float peak_release_scalar = std::exp(exp_factor / release_ms);
 
     
-    float filtered_peak = 0.0f;
-    std::vector<float> poly_filtered_peak;
+    // Peak of the mid signal in each chroma band, for linked analysis
+    std::vector<float> linked_peak;
+    
+    // Pitch class energy of the input, follows the input in both modes
+    Chromagram chromagram;
+    bool chromagram_active = false;
+    bool telemetry_active = false;
+    
+    // Analysis state for the telemetry feed
+    std::vector<float> chroma_energy;
+    int num_chroma_bands = 0;
     
     std::vector<float> current_phase = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
     float last_frequency = 0.0f;
@@ -106,11 +370,6 @@ private:
     
     bool disharmonic = true;
     
-    std::array<std::array<dsp::StateVariableTPTFilter<float>, 4>, 6> svf;
-    
-    Hilbert hilbert;
-    Rate rate_shifter;
-    
     DynamicFilter dyn_filter;
     
     
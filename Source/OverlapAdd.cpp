@@ -0,0 +1,141 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#include "OverlapAdd.hpp"
+
+void OverlapAddScheduler::prepare(int num_channels, int new_window_size, int new_hop_size, int history) {
+    jassert(new_hop_size > 0 && new_hop_size <= new_window_size);
+
+    window_size = new_window_size;
+    hop_size = new_hop_size;
+
+    window = &WindowCache::get(WindowCache::hann, window_size);
+
+    // Slices read the completed hops while the next one is written
+    int input_size = nextPowerOfTwo(history + hop_size);
+
+    // Frames are added ahead of the read position by up to a window, the hop before it is still being read
+    int output_size = nextPowerOfTwo(window_size + hop_size);
+
+    input.assign(num_channels, std::vector<float>(input_size, 0.0f));
+    output.assign(num_channels, std::vector<float>(output_size, 0.0f));
+
+    input_mask = input_size - 1;
+    output_mask = output_size - 1;
+
+    reset();
+}
+
+void OverlapAddScheduler::reset() {
+    for(auto& channel : input) std::fill(channel.begin(), channel.end(), 0.0f);
+    for(auto& channel : output) std::fill(channel.begin(), channel.end(), 0.0f);
+
+    position = hop_end = hop_count = 0;
+
+    // Nothing is due before the first hop is complete
+    executor.cancel();
+}
+
+void OverlapAddScheduler::set_work(int new_num_slices, std::function<void(int)> run_slice) {
+    executor.set_work(std::move(run_slice));
+    set_num_slices(new_num_slices);
+}
+
+void OverlapAddScheduler::set_num_slices(int new_num_slices) {
+    num_slices = new_num_slices;
+
+    executor.start(num_slices);
+    executor.cancel();
+}
+
+void OverlapAddScheduler::process(AudioBlock<float>& block) {
+    int num_channels = std::min<int>((int)block.getNumChannels(), (int)input.size());
+    int num_samples = (int)block.getNumSamples();
+
+    for(int done = 0; done < num_samples;) {
+        int hop_position = (int)(position - hop_end);
+        int num_to_copy = std::min(num_samples - done, hop_size - hop_position);
+
+        for(int ch = 0; ch < num_channels; ch++) {
+            auto* data = block.getChannelPointer(ch) + done;
+            auto& in = input[ch];
+            auto& out = output[ch];
+
+            for(int i = 0; i < num_to_copy; i++) {
+                int64 write_pos = position + i;
+                auto& slot = out[(write_pos - hop_size) & output_mask];
+
+                in[write_pos & input_mask] = data[i];
+                data[i] = slot;
+                slot = 0.0f;
+            }
+        }
+
+        position += num_to_copy;
+        done += num_to_copy;
+        hop_position += num_to_copy;
+
+        if(hop_position == hop_size) {
+            // The frame of the previous hop is due now
+            executor.finish();
+
+            hop_end = position;
+            hop_count++;
+            executor.start(num_slices);
+        }
+        else {
+            executor.advance(hop_position, hop_size);
+        }
+    }
+}
+
+void OverlapAddScheduler::read_input(int channel, int delay, float* destination, int num_samples) const {
+    jassert(delay + num_samples + hop_size <= (int)input[channel].size());
+
+    auto& in = input[channel];
+    int64 start = hop_end - delay - num_samples;
+
+    // At most two runs, one before and one after the wrap
+    for(int done = 0; done < num_samples;) {
+        int index = (int)((start + done) & input_mask);
+        int num_to_copy = std::min(num_samples - done, (int)in.size() - index);
+
+        std::copy(in.begin() + index, in.begin() + index + num_to_copy, destination + done);
+        done += num_to_copy;
+    }
+}
+
+void OverlapAddScheduler::add_frame(int channel, float* frame) {
+    WindowCache::apply(*window, frame);
+
+    auto& out = output[channel];
+
+    for(int done = 0; done < window_size;) {
+        int index = (int)((hop_end + done) & output_mask);
+        int num_to_add = std::min(window_size - done, (int)out.size() - index);
+
+        FloatVectorOperations::add(out.data() + index, frame + done, num_to_add);
+        done += num_to_add;
+    }
+}
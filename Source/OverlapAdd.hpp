@@ -0,0 +1,88 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include "SliceExecutor.hpp"
+#include "WindowCache.hpp"
+
+#include <JuceHeader.h>
+
+// Overlap-add where the work for each hop is cut into slices that are spread over the callbacks of the next hop
+//
+// When a hop of input is complete, its slices run in order while the next hop comes in (see SliceExecutor).
+// Whatever is left runs as the hop ends, so a frame is always done before its first sample is due.
+// A 64 sample callback only ever runs a slice or two, never a whole frame.
+//
+// The frame of a hop is added to the output from the end of that hop on, and comes out hop_size samples later.
+// Input and output are ring buffers indexed by the absolute sample position, all memory is allocated in prepare().
+
+class OverlapAddScheduler
+{
+public:
+
+    // history is how far before the end of a hop the slices may still read the input
+    void prepare(int num_channels, int window_size, int hop_size, int history);
+
+    void reset();
+
+    // The work for each hop, run_slice is called with slice indices 0 to num_slices - 1 in order
+    void set_work(int num_slices, std::function<void(int)> run_slice);
+
+    // Changing the number of slices drops what was left of the current hop
+    void set_num_slices(int num_slices);
+
+    // Replaces the input with the output, hop_size samples later
+    void process(AudioBlock<float>& block);
+
+    // Copies num_samples of input, ending delay samples before the end of the last complete hop
+    void read_input(int channel, int delay, float* destination, int num_samples) const;
+
+    // Windows a frame of window_size samples in place, then adds it to the output from the end of the last complete hop
+    void add_frame(int channel, float* frame);
+
+    int get_latency() const { return hop_size; }
+
+    // Hops completed since the last reset, tells apart the frames that overlap each other
+    int64 get_hop_count() const { return hop_count; }
+
+    // Samples taken in since the last reset, and where the last complete hop ended
+    int64 get_position() const { return position; }
+    int64 get_hop_end() const { return hop_end; }
+
+private:
+
+    int window_size = 0, hop_size = 0;
+
+    // Hann, overlapping windows at half a window apart add up to exactly one
+    const std::vector<float>* window = nullptr;
+
+    std::vector<std::vector<float>> input, output;
+    int64 input_mask = 0, output_mask = 0;
+
+    int64 position = 0, hop_end = 0, hop_count = 0;
+
+    SliceExecutor executor;
+    int num_slices = 0;
+};
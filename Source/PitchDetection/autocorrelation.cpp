@@ -3,7 +3,7 @@
 #include <complex>
 //#include <ffts/ffts.h>
 
-#include "tools/kiss_fftr.h"
+#include "../Kernels/Kernels.hpp"
 
 #include <numeric>
 #include <vector>
@@ -20,17 +20,15 @@ util::acorr_r(const std::vector<T> &audio_buffer, pitch_alloc::BaseAlloc<T> *ba)
             return std::complex(x, static_cast<T>(0.0));
         }); */
     
-    kiss_fftr(ba->fft_forward, audio_buffer.data(), (kiss_fft_cpx*)ba->out_im.data());
+    ba->fft_forward.perform(audio_buffer.data(), ba->out_im.data(), ba->fft_scratch.data());
     
     //ffts_execute(ba->fft_forward, ba->out_im.data(), ba->out_im.data());
 
-    std::complex<float> scale = {
-        1.0f / (float)(ba->N * 2), static_cast<T>(0.0)};
+    float scale = 1.0f / (float)(ba->N * 2);
     
-    for (int i = 0; i < ba->N; ++i)
-        ba->out_im[i] *= std::conj(ba->out_im[i]) * scale;
+    Kernels::get().power_spectrum((float*)ba->out_im.data(), scale, (int)ba->N);
 
-    kiss_fftri(ba->fft_backward, (kiss_fft_cpx*)ba->out_im.data(), ba->out_real.data());
+    ba->fft_backward.perform(ba->out_im.data(), ba->out_real.data(), ba->fft_scratch.data());
 }
 
 template void
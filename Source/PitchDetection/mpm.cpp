@@ -101,6 +101,8 @@ pitch_alloc::Mpm<T>::probabilistic_pitch(
 		cutoff += MPM_CUTOFF;
 	}
 
+	confidence = 0;
+
 	for (auto tau_estimate : t0_with_probability) {
 		if (tau_estimate.first == 0.0) {
 			continue;
@@ -112,6 +114,7 @@ pitch_alloc::Mpm<T>::probabilistic_pitch(
 		if (f0 != -1.0) {
 			f0_with_probability.push_back(
 			    std::make_pair(f0, tau_estimate.second));
+			confidence += tau_estimate.second;
 		}
 	}
 	this->clear();
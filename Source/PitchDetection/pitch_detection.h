@@ -2,7 +2,7 @@
 #define PITCH_DETECTION_H
 
 #include <complex>
-#include "tools/kiss_fftr.h"
+#include "../FFTPlan.hpp"
 //#include <ffts/ffts.h>
 #include <mlpack/core.hpp>
 #include <mlpack/methods/hmm/hmm.hpp>
@@ -77,9 +77,11 @@ template <typename T> class BaseAlloc
     long N;
     std::vector<std::complex<float>> out_im;
     std::vector<T> out_real;
+    std::vector<std::complex<float>> fft_scratch;
     
-    kiss_fftr_cfg fft_forward;
-    kiss_fftr_cfg fft_backward;
+    // Shared with every other detector of the same size
+    const FFTPlan& fft_forward;
+    const FFTPlan& fft_backward;
     
     //ffts_plan_t *fft_forward;
     //ffts_plan_t *fft_backward;
@@ -87,14 +89,15 @@ template <typename T> class BaseAlloc
 
     BaseAlloc(long audio_buffer_size)
         : N(audio_buffer_size), out_im(std::vector<std::complex<float>>(N * 2)),
-          out_real(std::vector<T>(N))
+          out_real(std::vector<T>(N)),
+          fft_forward(FFTPlan::get(N, FFTPlan::forward)),
+          fft_backward(FFTPlan::get(N, FFTPlan::inverse))
     {
         if (N == 0) {
             throw std::bad_alloc();
         }
 
-        fft_forward = kiss_fftr_alloc(N, false, 0, 0);
-        fft_backward = kiss_fftr_alloc(N, true, 0, 0);
+        fft_scratch.resize(fft_forward.get_scratch_size());
         
         //fft_forward = ffts_init_1d(N * 2, FFTS_FORWARD);
         //fft_backward = ffts_init_1d(N * 2, FFTS_BACKWARD);
@@ -104,8 +107,6 @@ template <typename T> class BaseAlloc
 
     ~BaseAlloc()
     {
-        kiss_fft_free(fft_forward);
-        kiss_fft_free(fft_backward);
         //ffts_free(fft_forward);
         //ffts_free(fft_backward);
     }
@@ -136,6 +137,12 @@ template <typename T> class Mpm : public BaseAlloc<T>
 
     T
     probabilistic_pitch(const std::vector<T> &, int);
+
+    /*
+     * Share of the cutoffs that found a period in the last
+     * probabilistic_pitch call, from 0 (unvoiced) to 1
+     */
+    T confidence = 0;
 };
 
 /*
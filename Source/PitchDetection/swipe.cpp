@@ -212,7 +212,8 @@ loudness(
 	std::vector<float> fi(w);
 	std::vector<std::complex<float>> fo(w);
     
-    kiss_fftr_cfg plan = kiss_fftr_alloc(w, false, 0, 0);
+    auto& plan = FFTPlan::get(w, FFTPlan::forward);
+    std::vector<std::complex<float>> scratch(plan.get_scratch_size());
     
 	//ffts_plan_t *plan = ffts_init_1d(w, FFTS_FORWARD);
     
@@ -230,14 +231,14 @@ loudness(
 	for (/* j = w2 */; j < (size_t)w; j++)
         fi[j] = (float)(x[j - w2] * hann[j]);
     
-    kiss_fftr(plan, fi.data(), (kiss_fft_cpx*)fo.data());
+    plan.perform(fi.data(), fo.data(), scratch.data());
 	//ffts_execute(plan, fi.data(), fo.data());
     
 	La(L, f, fERBs, fo, w2, hi, 0);
 	for (i = 1; i < L.size() - 2; i++) {
 		for (j = 0; j < (size_t)w; j++)
             fi[j] = (float)(x[j + offset] * hann[j]);
-        kiss_fftr(plan, fi.data(), (kiss_fft_cpx*)fo.data());
+        plan.perform(fi.data(), fo.data(), scratch.data());
 		//ffts_execute(plan, fi.data(), fo.data());
 		La(L, f, fERBs, fo, w2, hi, i);
 		offset += w2;
@@ -248,7 +249,7 @@ loudness(
 		for (/* j = x.size() - offset */; j < (size_t)w; j++)
             fi[j] = 0.0f;
         
-        kiss_fftr(plan, fi.data(), (kiss_fft_cpx*)fo.data());
+        plan.perform(fi.data(), fo.data(), scratch.data());
 		//ffts_execute(plan, fi.data(), fo.data());
 		La(L, f, fERBs, fo, w2, hi, i);
 		offset += w2;
@@ -264,7 +265,6 @@ loudness(
 		}
 	}
     
-    kiss_fft_free(plan);
 	//ffts_free(plan);
 	return L;
 }
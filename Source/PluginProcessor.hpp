@@ -1,148 +1,162 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-/**********************************************************************
-*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
-*                      Utrecht, the Netherlands
-*                          All rights reserved
-***********************************************************************
-*  This program is free software: you can redistribute it and/or modify
-*  it under the terms of the GNU General Public License as published by
-*  the Free Software Foundation, either version 3 of the License, or
-*  (at your option) any later version.
-*
-*  This program is distributed in the hope that it will be useful,
-*  but WITHOUT ANY WARRANTY; without even the implied warranty of
-*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-*  GNU General Public License for more details.
-*
-*  You should have received a copy of the GNU General Public License
-*  along with this program.
-*  If not, see <http://www.gnu.org/licenses/>.
-***********************************************************************
-*
-*  Author             : Timothy Schoen
-*  E-mail             : timschoen123@gmail.com
-*
-**********************************************************************/
-#pragma once
-
-#include "EnvelopeFollower.hpp"
-#include "Filterbanks/Filterbank.hpp"
-#include "concurrentqueue.hpp"
-#include "ChebyshevTable.hpp"
-
-
-#include "MonoDistortion.hpp"
-#include "ChromaFilter.hpp"
-
-#include <JuceHeader.h>
-
-
-class ZirconAudioProcessor  : public AudioProcessor, public ValueTree::Listener, public AudioProcessorValueTreeState::Listener
-{
-public:
-    //==============================================================================
-    ZirconAudioProcessor();
-    ~ZirconAudioProcessor() override;
-
-    //==============================================================================
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-   #ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
-   #endif
-
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    //==============================================================================
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    //==============================================================================
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    //==============================================================================
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
-
-    //==============================================================================
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
-    
-    void valueTreeChildRemoved(ValueTree &parent_tree, ValueTree &removed_child, int idx) override;
-    void valueTreeChildAdded(ValueTree &parent_tree, ValueTree &added_child) override;
-    void valueTreePropertyChanged (ValueTree &changed_tree, const Identifier &property) override;
-    
-    void parameterChanged (const String &parameter_id, float new_value) override;
-
-    AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    
-    ValueTree main_tree = ValueTree("Main");
-    
-private:
-    
-    ProcessSpec last_spec;
-    ProcessSpec oversampled_spec;
-    
-    moodycamel::ConcurrentQueue<std::function<void()>> queue;
-    
-    std::unique_ptr<Filterbank> filter_bank;
-    OwnedArray<ChebyshevTable> chebyshev_distortions;
-    
-    void add_harmonic();
-    
-    void set_num_bands(int selection, bool reset = false);
-    void set_oversample_rate(int new_oversample_factor);
-    
-    std::vector<float> get_centre_freqs();
-    
-    float sample_rate;
-    int num_bands;
-    int block_size;
-    
-    const int max_bands = 50;
-    const int max_voices = 5;
-    
-    int oversample_factor = 1;
-    SmoothedValue<float> master_volume;
-    SmoothedValue<float> tone_cutoff;
-    SmoothedValue<float> gain;
-    
-    bool high_mode = false;
-    bool smooth_mode = false;
-
-    std::unique_ptr<EnvelopeFollower> envelope_follower;
-    
-    AudioBlock<float> tone_block, gain_block;
-    HeapBlock<char> tone_data, gain_data;
-    
-    std::vector<HeapBlock<char>> band_data, iamp_data, band_tone_data, write_data, inv_data, phase_data;
-    std::vector<AudioBlock<float>> inv_scaling, instant_amp, split_bands, write_bands, band_tone, read_bands, phase_bands;
-    
-    std::unique_ptr<Oversampling<float>> oversampler;
-    
-    DryWetMixer<float> mixer = DryWetMixer<float>(22050);
-    
-    AudioProcessorValueTreeState proc_valuetree;
-    
-    MonoDistortion mono_distortion;
-   // ChromaFilter chroma_filter;
-    
-    //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZirconAudioProcessor)
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include "EnvelopeFollower.hpp"
+#include "Filterbanks/Filterbank.hpp"
+#include "concurrentqueue.hpp"
+#include "ChebyshevTable.hpp"
+#include "TransportState.hpp"
+#include "Telemetry.hpp"
+#include "SilenceDetector.hpp"
+
+
+#include "MonoDistortion.hpp"
+#include "ChromaFilter.hpp"
+
+#include <JuceHeader.h>
+
+
+class ZirconAudioProcessor  : public AudioProcessor, public ValueTree::Listener, public AudioProcessorValueTreeState::Listener, private AsyncUpdater
+{
+public:
+    //==============================================================================
+    ZirconAudioProcessor();
+    ~ZirconAudioProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    void reset() override;
+
+   #ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+   #endif
+
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    //==============================================================================
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    //==============================================================================
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+    
+    void valueTreeChildRemoved(ValueTree &parent_tree, ValueTree &removed_child, int idx) override;
+    void valueTreeChildAdded(ValueTree &parent_tree, ValueTree &added_child) override;
+    void valueTreePropertyChanged (ValueTree &changed_tree, const Identifier &property) override;
+    
+    void parameterChanged (const String &parameter_id, float new_value) override;
+
+    AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    
+    ValueTree main_tree = ValueTree("Main");
+    
+    // Engine state for the editor, written once per block
+    TripleBuffer<TelemetryFrame> telemetry;
+    
+private:
+    
+    ProcessSpec last_spec;
+    
+    moodycamel::ConcurrentQueue<std::function<void()>> queue;
+    
+    std::unique_ptr<Filterbank> filter_bank;
+    OwnedArray<ChebyshevTable> chebyshev_distortions;
+    TransportState transport;
+    SilenceDetector silence_detector;
+    
+    void add_harmonic();
+    
+    void set_num_bands(int selection, bool reset = false);
+    
+    // Lines the dry signal up with the engine's current mode, and tells the host when that changes
+    void update_latency();
+    void handleAsyncUpdate() override;
+    
+    // Latency of the current mode, written on the audio thread, reported to the host from the message thread
+    std::atomic<int> latency_samples { 0 };
+    void set_oversample_rate(int new_oversample_factor);
+    
+    std::vector<float> get_centre_freqs();
+    
+    float sample_rate;
+    int num_bands;
+    int block_size;
+    
+    const int max_bands = 50;
+    const int max_voices = 5;
+    
+    int oversample_factor = 1;
+    HalfbandOversampler::Mode oversampling_mode = HalfbandOversampler::low_latency;
+    BlockSmoother<> master_volume;
+    SmoothedValue<float> tone_cutoff;
+    SmoothedValue<float> gain;
+    
+    bool high_mode = false;
+    bool smooth_mode = false;
+
+    std::unique_ptr<EnvelopeFollower> envelope_follower;
+    
+    AudioBlock<float> tone_block, gain_block;
+    HeapBlock<char> tone_data, gain_data;
+    
+    std::vector<HeapBlock<char>> band_data, iamp_data, band_tone_data, write_data, inv_data, phase_data;
+    std::vector<AudioBlock<float>> inv_scaling, instant_amp, split_bands, write_bands, band_tone, read_bands, phase_bands;
+    
+    DryWetMixer<float> mixer = DryWetMixer<float>(22050);
+    
+    AudioProcessorValueTreeState proc_valuetree;
+    
+    MonoDistortion mono_distortion;
+   // ChromaFilter chroma_filter;
+    
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZirconAudioProcessor)
+};
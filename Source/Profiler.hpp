@@ -0,0 +1,185 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <chrono>
+
+// Per-stage timing of the DSP, for finding out which stage dominates a block
+// Build with ZIRCON_PROFILING=1 to enable it, otherwise ZIRCON_PROFILE_SCOPE expands to nothing
+//
+// Timings go into log-spaced histograms with relaxed atomic counters: the audio thread never locks,
+// and the editor or a dump can read p50, p99 and max per stage at any time.
+// The histograms are shared by all instances in the process.
+
+#ifndef ZIRCON_PROFILING
+#define ZIRCON_PROFILING 0
+#endif
+
+namespace Profiler
+{
+
+enum Stage
+{
+    process_block,
+    parameter_queue,
+    mono_distortion,
+    chroma_filter,
+    chromagram,
+    poly_waveshaper,
+    hilbert,
+    pitch_tracking,
+    mono_waveshaper,
+    dry_wet_mix,
+    num_stages
+};
+
+inline const char* get_stage_name(int stage) {
+    static const char* names[num_stages] = {
+        "processBlock",
+        "Parameter queue",
+        "MonoDistortion",
+        "ChromaFilter",
+        "Chromagram",
+        "Poly waveshaper",
+        "Hilbert",
+        "Pitch tracking",
+        "Mono waveshaper",
+        "Dry/wet mix"
+    };
+    
+    return names[stage];
+}
+
+// Quarter-octave bins over durations in nanoseconds, from 1 ns up to about 4 seconds
+struct Histogram
+{
+    static constexpr int bins_per_octave = 4;
+    static constexpr int num_bins = 32 * bins_per_octave;
+    
+    std::array<std::atomic<uint32_t>, num_bins> bins {};
+    std::atomic<uint64_t> max_ns { 0 };
+    std::atomic<uint64_t> count { 0 };
+    
+    void add(uint64_t ns) {
+        int bin = ns > 0 ? (int)(std::log2((double)ns) * bins_per_octave) : 0;
+        bins[std::clamp(bin, 0, num_bins - 1)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        
+        // The histograms are shared by every instance in the process, and hosts run instances on different threads,
+        // so several threads can race to raise the maximum
+        uint64_t current = max_ns.load(std::memory_order_relaxed);
+        while(ns > current && !max_ns.compare_exchange_weak(current, ns, std::memory_order_relaxed)) {}
+    }
+    
+    // Centre of the bin that holds the given fraction of all samples, in nanoseconds
+    double get_percentile(double fraction) const {
+        uint64_t total = count.load(std::memory_order_relaxed);
+        if(total == 0) return 0.0;
+        
+        uint64_t target = (uint64_t)std::ceil(fraction * total), seen = 0;
+        
+        for(int b = 0; b < num_bins; b++) {
+            seen += bins[b].load(std::memory_order_relaxed);
+            if(seen >= target) return std::exp2((b + 0.5) / bins_per_octave);
+        }
+        
+        return (double)max_ns.load(std::memory_order_relaxed);
+    }
+    
+    void reset() {
+        for(auto& bin : bins) bin.store(0, std::memory_order_relaxed);
+        max_ns.store(0, std::memory_order_relaxed);
+        count.store(0, std::memory_order_relaxed);
+    }
+};
+
+inline std::array<Histogram, num_stages>& get_histograms() {
+    static std::array<Histogram, num_stages> histograms;
+    return histograms;
+}
+
+// Records the lifetime of the scope into the histogram of a stage
+struct ScopedTimer
+{
+    ScopedTimer(Stage timed_stage) : stage(timed_stage), start(std::chrono::steady_clock::now()) {}
+    
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        get_histograms()[stage].add((uint64_t)elapsed.count());
+    }
+    
+    Stage stage;
+    std::chrono::steady_clock::time_point start;
+};
+
+struct StageSummary
+{
+    String name;
+    uint64_t count;
+    
+    // Microseconds
+    double p50, p99, max;
+};
+
+inline std::vector<StageSummary> get_summary() {
+    std::vector<StageSummary> result;
+    
+    for(int s = 0; s < num_stages; s++) {
+        auto& histogram = get_histograms()[s];
+        
+        result.push_back({get_stage_name(s),
+                          histogram.count.load(std::memory_order_relaxed),
+                          histogram.get_percentile(0.5) / 1000.0,
+                          histogram.get_percentile(0.99) / 1000.0,
+                          histogram.max_ns.load(std::memory_order_relaxed) / 1000.0});
+    }
+    
+    return result;
+}
+
+inline void reset() {
+    for(auto& histogram : get_histograms()) histogram.reset();
+}
+
+// Writes a table of all stages, for benchmarks and command line runs
+inline bool dump(const File& file) {
+    String text = "stage, count, p50 (us), p99 (us), max (us)\n";
+    
+    for(auto& stage : get_summary()) {
+        text << stage.name << ", " << String((int64)stage.count) << ", " << String(stage.p50, 2) << ", " << String(stage.p99, 2) << ", " << String(stage.max, 2) << "\n";
+    }
+    
+    return file.replaceWithText(text);
+}
+
+}
+
+#if ZIRCON_PROFILING
+#define ZIRCON_PROFILE_SCOPE(stage) Profiler::ScopedTimer JUCE_JOIN_MACRO(profiler_timer_, __LINE__)(Profiler::stage)
+#else
+#define ZIRCON_PROFILE_SCOPE(stage)
+#endif
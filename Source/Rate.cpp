@@ -1,130 +1,153 @@
-#include "Rate.hpp"
-#define QUANT(f1,f2)            float(floor((f1)*(f2)+0.5)/(f2))
-
-void Rate::prepare(const dsp::ProcessSpec& spec) {
-    phase.resize(spec.numChannels, 0.0);
-    mult.resize(spec.numChannels, 1.0);
-    invmult.resize(spec.numChannels, 1.0);
-    prev.resize(spec.numChannels, 0.0);
-    wantlock.resize(spec.numChannels, 1);
-    
-    ratio.reset(spec.sampleRate, 0.1);
-}
-
-void Rate::set_ratio(float new_ratio) {
-    
-    ratio.setTargetValue(new_ratio);
-}
-
-void Rate::set_stereo(bool stereo) {
-    is_stereo = stereo;
-}
-
-void Rate::process(dsp::AudioBlock<float>& input_block, dsp::AudioBlock<float>& output_block, int mode) {
-    
-    if(mode == 0){
-        process_cycle(input_block, output_block);
-    }
-    else {
-        process_lock(input_block, output_block);
-    }
-}
-
-
-void Rate::process_lock(dsp::AudioBlock<float>& input_block, dsp::AudioBlock<float>& output_block) {
-    
-    for(int n = 0; n < input_block.getNumSamples(); n++) {
-        float current_ratio = ratio.getNextValue();
-        
-        for(int ch = 0; ch < input_block.getNumChannels(); ch++) {
-            float ch_ratio = (is_stereo && (ch & 1)) ? current_ratio : 1.0f / current_ratio;
-            float input = input_block.getSample(ch, n);
-            
-            // did multiplier change?
-            if (ch_ratio != mult[ch] && std::isfinite(ch_ratio) && ch_ratio != 0) {
-                mult[ch] = ch_ratio;
-                invmult[ch] = 1.0f / mult[ch];
-                wantlock[ch] = 1;
-            }
-            float diff = input - prev[ch];
-            
-            if (diff < -0.5f) {
-                diff += 1.0f;
-            } else if (diff > 0.5f) {
-                diff -= 1.0f;
-            }
-            
-            if (wantlock[ch]) {
-                // recalculate phase
-                phase[ch] = (input - QUANT(input, quant)) * invmult[ch]
-                + QUANT(input, quant * mult[ch]);
-                diff = 0;
-                wantlock[ch] = 0;
-            } else {
-                // diff is always between -0.5 and 0.5
-                phase[ch] += diff * invmult[ch];
-            }
-            
-            if (phase[ch] > 1.0f || phase[ch] < 0.0f) {
-                phase[ch] = phase[ch] - (long)(phase[ch]);
-            }
-            
-            prev[ch] = input;
-            
-            output_block.setSample(ch, n, phase[ch]);
-        }
-    }
-    //return phase;
-    
-    
-}
-
-
-void Rate::process_cycle(dsp::AudioBlock<float>& input_block, dsp::AudioBlock<float>& output_block) {
-    
-    
-    for(int n = 0; n < input_block.getNumSamples(); n++) {
-        float current_ratio = ratio.getNextValue();
-        
-        for(int ch = 0; ch < input_block.getNumChannels(); ch++) {
-            float ch_ratio = (is_stereo && (ch & 1)) ? current_ratio : 1.0f / current_ratio;
-            float input = input_block.getSample(ch, n);
-            
-            if (ch_ratio != mult[ch] && std::isfinite(ch_ratio) && ch_ratio != 0.0f) {
-                mult[ch] = ch_ratio;
-                invmult[ch] = 1.0f / mult[ch];
-                wantlock[ch] = 1;
-            }
-            float diff = input - prev[ch];
-            
-            if (diff < -0.5f) {
-                if (wantlock[ch]) {
-                    wantlock[ch] = 0;
-                    phase[ch] = input * invmult[ch];
-                    diff = 0.0f;
-                } else {
-                    diff += 1.0f;
-                }
-            } else if (diff > 0.5f) {
-                if (wantlock[ch]) {
-                    wantlock[ch] = 0;
-                    phase[ch] = input * invmult[ch];
-                    diff = 0.0f;
-                } else {
-                    diff -= 1.0f;
-                }
-            }
-            
-            // diff is always between -0.5 and 0.5
-            phase[ch] += diff * invmult[ch];
-            
-            if (phase[ch] > 1.0f || phase[ch] < 0.0f) {
-                phase[ch] = phase[ch] - (long)(phase[ch]);
-            }
-            
-            prev[ch] = input;
-            
-            output_block.setSample(ch, n, phase[ch]);
-        }
-    }
-}
+#include "Rate.hpp"
+#define QUANT(f1,f2)            float(floor((f1)*(f2)+0.5)/(f2))
+
+void Rate::prepare(const dsp::ProcessSpec& spec) {
+    phase.resize(spec.numChannels, 0.0);
+    mult.resize(spec.numChannels, 1.0);
+    invmult.resize(spec.numChannels, 1.0);
+    prev.resize(spec.numChannels, 0.0);
+    wantlock.resize(spec.numChannels, 1);
+    
+    steps.resize(spec.maximumBlockSize);
+    input_pointers.resize(spec.numChannels);
+    output_pointers.resize(spec.numChannels);
+    
+    ratio.reset(spec.sampleRate, 0.1);
+}
+
+void Rate::reset() {
+    std::fill(phase.begin(), phase.end(), 0.0f);
+    std::fill(prev.begin(), prev.end(), 0.0f);
+    std::fill(mult.begin(), mult.end(), 1.0f);
+    std::fill(invmult.begin(), invmult.end(), 1.0f);
+    std::fill(wantlock.begin(), wantlock.end(), 1);
+    
+    ratio.setCurrentAndTargetValue(ratio.getTargetValue());
+}
+
+void Rate::set_ratio(float new_ratio) {
+    
+    ratio.setTargetValue(new_ratio);
+}
+
+void Rate::set_stereo(bool stereo) {
+    is_stereo = stereo;
+}
+
+void Rate::process(dsp::AudioBlock<float>& input_block, dsp::AudioBlock<float>& output_block, int mode) {
+    int num_channels = (int)std::min({input_block.getNumChannels(), output_block.getNumChannels(), input_pointers.size()});
+    
+    for(int ch = 0; ch < num_channels; ch++) {
+        input_pointers[ch] = input_block.getChannelPointer(ch);
+        output_pointers[ch] = output_block.getChannelPointer(ch);
+    }
+    
+    process(input_pointers.data(), output_pointers.data(), num_channels, (int)input_block.getNumSamples(), mode);
+}
+
+void Rate::process(const float* const* input, float* const* output, int num_channels, int num_samples, int mode) {
+    jassert(num_channels <= (int)phase.size() && num_samples <= (int)steps.size());
+    
+    // Ratio at the start and the end of this block
+    float ratio_start = ratio.getCurrentValue();
+    float ratio_end = ratio.skip(num_samples);
+    
+    for(int ch = 0; ch < num_channels; ch++) {
+        bool inverse = !(is_stereo && (ch & 1));
+        
+        float mult_start = inverse ? 1.0f / ratio_start : ratio_start;
+        float mult_end = inverse ? 1.0f / ratio_end : ratio_end;
+        
+        // Keep the last valid multiplier for broken ratios
+        if(!std::isfinite(mult_start) || mult_start == 0.0f) mult_start = mult[ch];
+        if(!std::isfinite(mult_end) || mult_end == 0.0f) mult_end = mult_start;
+        
+        // did multiplier change?
+        if(mult_start != mult[ch]) {
+            wantlock[ch] = 1;
+        }
+        
+        // Reciprocals once per block, the ramp in between is linear
+        float invmult_start = mult_start == mult[ch] ? invmult[ch] : 1.0f / mult_start;
+        float invmult_end = mult_end == mult_start ? invmult_start : 1.0f / mult_end;
+        
+        mult[ch] = mult_start;
+        process_channel(ch, input[ch], output[ch], num_samples, invmult_start, invmult_end, mode);
+        
+        // Still ramping: lock again once the ratio has settled
+        if(mult_end != mult_start) wantlock[ch] = 1;
+        
+        mult[ch] = mult_end;
+        invmult[ch] = invmult_end;
+    }
+}
+
+void Rate::process_channel(int ch, const float* input, float* output, int num_samples, float invmult_start, float invmult_end, int mode) {
+    if(num_samples == 0) return;
+    
+    float* step = steps.data();
+    float invmult_increment = (invmult_end - invmult_start) / num_samples;
+    
+    // Pass 1: input differences, wrapped to [-0.5, 0.5] and scaled by the (ramped) inverse ratio
+    step[0] = input[0] - prev[ch];
+    for(int n = 1; n < num_samples; n++) {
+        step[n] = input[n] - input[n - 1];
+    }
+    
+    // Where the input phasor wraps, for cycle mode
+    int lock_index = -1;
+    if(wantlock[ch] && mode == cycle) {
+        for(int n = 0; n < num_samples; n++) {
+            if(std::abs(step[n]) > 0.5f) {
+                lock_index = n;
+                break;
+            }
+        }
+    }
+    
+    for(int n = 0; n < num_samples; n++) {
+        float diff = step[n];
+        diff -= (float)(diff > 0.5f) - (float)(diff < -0.5f);
+        step[n] = diff * (invmult_start + invmult_increment * n);
+    }
+    
+    float current = phase[ch];
+    
+    if(wantlock[ch] && mode == lock) {
+        // recalculate phase
+        float input_value = input[0];
+        current = (input_value - QUANT(input_value, quant)) * invmult_start + QUANT(input_value, quant * mult[ch]);
+        step[0] = 0.0f;
+        wantlock[ch] = 0;
+    }
+    else if(lock_index >= 0) {
+        // Jump to the scaled input at the wrap, the steps before it still run at the old ratio
+        step[lock_index] = 0.0f;
+        wantlock[ch] = 0;
+    }
+    
+    // Pass 2: running sum, the only dependency between samples
+    // Chunks keep the sum small so it doesn't lose precision before it's wrapped
+    constexpr int chunk_size = 32;
+    
+    for(int start = 0; start < num_samples; start += chunk_size) {
+        int end = std::min(start + chunk_size, num_samples);
+        
+        for(int n = start; n < end; n++) {
+            if(n == lock_index) current = input[n] * (invmult_start + invmult_increment * n);
+            
+            current += step[n];
+            output[n] = current;
+        }
+        
+        // Pass 3: wrap to [0, 1)
+        for(int n = start; n < end; n++) {
+            output[n] -= std::floor(output[n]);
+        }
+        
+        current = output[end - 1];
+    }
+    
+    phase[ch] = current;
+    prev[ch] = input[num_samples - 1];
+}
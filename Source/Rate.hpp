@@ -1,131 +1,154 @@
-#pragma once
-
-#include <JuceHeader.h>
-#include "Hilbert.hpp"
-
-// Time-scaling for phasor ramps, similar to Max/MSP's rate~ object
-
-struct Rate
-{
-    void prepare(const dsp::ProcessSpec& spec);
-    
-    void set_ratio(float new_ratio);
-    void set_stereo(bool stereo);
-    
-    void process(dsp::AudioBlock<float>& input_block, dsp::AudioBlock<float>& output_block, int mode = 0);
-    
-    void process_lock(dsp::AudioBlock<float>& input_block, dsp::AudioBlock<float>& output_block);
-    void process_cycle(dsp::AudioBlock<float>& input_block, dsp::AudioBlock<float>& output_block);
-    
-    
-    bool is_stereo = false;
-    SmoothedValue<float> ratio = 1;
-    std::vector<float> phase, mult, invmult, prev;
-    std::vector<int> wantlock;
-    int quant = 1;
-    
-};
-
-
-/*
- inline float process_cycle(float input, float ratio) {
- 
- if (ratio != mult && std::isfinite(ratio) && ratio != 0.0f) {
- mult = ratio;
- invmult = 1.0f / mult;
- wantlock = 1;
- }
- float diff = input - prev;
- 
- if (diff < -0.5f) {
- if (wantlock) {
- wantlock = 0;
- phase = input * invmult;
- diff = 0.0f;
- } else {
- diff += 1.0f;
- }
- } else if (diff > 0.5f) {
- if (wantlock) {
- wantlock = 0;
- phase = input * invmult;
- diff = 0.0f;
- } else {
- diff -= 1.0f;
- }
- }
- 
- // diff is always between -0.5 and 0.5
- phase += diff * invmult;
- 
- if (phase > 1.0f || phase < 0.0f) {
- phase = phase - (long)(phase);
- }
- 
- prev = input;
- 
- return phase;
- }
- 
- 
- 
- inline float process_lock(float input, float ratio) {
- // did multiplier change?
- if (ratio != mult && std::isfinite(ratio) && ratio != 0) {
- mult = ratio;
- invmult = 1.0f / mult;
- wantlock = 1;
- }
- float diff = input - prev;
- 
- if (diff < -0.5f) {
- diff += 1.0f;
- } else if (diff > 0.5f) {
- diff -= 1.0f;
- }
- 
- if (wantlock) {
- // recalculate phase
- phase = (input - QUANT(input, quant)) * invmult
- + QUANT(input, quant * mult);
- diff = 0;
- wantlock = 0;
- } else {
- // diff is always between -0.5 and 0.5
- phase += diff * invmult;
- }
- 
- if (phase > 1.0f || phase < 0.0f) {
- phase = phase - (long)(phase);
- }
- 
- prev = input;
- 
- return phase;
- }
- 
- inline float process_off(float input, float ratio) {
- // did multiplier change?
- if (ratio != mult && std::isfinite(ratio) && ratio != 0.0) {
- mult = ratio;
- invmult = 1.0 / mult;
- wantlock = 1;
- }
- float diff = input - prev;
- 
- if (diff < float(-0.5)) {
- diff += float(1);
- } else if (diff > float(0.5)) {
- diff -= float(1);
- }
- 
- phase += diff * invmult;
- 
- if (phase > float(1.) || phase < float(-0.)) {
- phase = phase - (long)(phase);
- }
- 
- prev = input;
- 
- return phase;
- } */
+#pragma once
+
+#include <JuceHeader.h>
+#include "Hilbert.hpp"
+
+// Time-scaling for phasor ramps, similar to Max/MSP's rate~ object
+// Channels are processed one at a time over the whole block:
+// the per-sample work is split into passes without loop-carried dependencies, which vectorise,
+// and a single running sum, so many channels (like one per harmonic) stay cheap
+// Nothing renders through it at the moment, the shapers in MonoDistortion take their harmonics straight from the input phase
+
+struct Rate
+{
+    enum Mode
+    {
+        cycle, // Change ratio at the next wrap of the input phasor
+        lock   // Change ratio right away, quantised to the input
+    };
+    
+    void prepare(const dsp::ProcessSpec& spec);
+    
+    // Clears the phases and jumps to the target ratio
+    void reset();
+    
+    void set_ratio(float new_ratio);
+    void set_stereo(bool stereo);
+    
+    void process(dsp::AudioBlock<float>& input_block, dsp::AudioBlock<float>& output_block, int mode = cycle);
+    
+    void process(const float* const* input, float* const* output, int num_channels, int num_samples, int mode = cycle);
+    
+    bool is_stereo = false;
+    
+    // The ratio is ramped at block rate: start and end value per block, linear in between
+    SmoothedValue<float> ratio = 1;
+    
+    std::vector<float> phase, mult, invmult, prev;
+    std::vector<int> wantlock;
+    int quant = 1;
+    
+private:
+    
+    void process_channel(int ch, const float* input, float* output, int num_samples, float invmult_start, float invmult_end, int mode);
+    
+    // Scaled input differences for one channel
+    std::vector<float> steps;
+    
+    std::vector<const float*> input_pointers;
+    std::vector<float*> output_pointers;
+};
+
+
+/*
+ inline float process_cycle(float input, float ratio) {
+ 
+ if (ratio != mult && std::isfinite(ratio) && ratio != 0.0f) {
+ mult = ratio;
+ invmult = 1.0f / mult;
+ wantlock = 1;
+ }
+ float diff = input - prev;
+ 
+ if (diff < -0.5f) {
+ if (wantlock) {
+ wantlock = 0;
+ phase = input * invmult;
+ diff = 0.0f;
+ } else {
+ diff += 1.0f;
+ }
+ } else if (diff > 0.5f) {
+ if (wantlock) {
+ wantlock = 0;
+ phase = input * invmult;
+ diff = 0.0f;
+ } else {
+ diff -= 1.0f;
+ }
+ }
+ 
+ // diff is always between -0.5 and 0.5
+ phase += diff * invmult;
+ 
+ if (phase > 1.0f || phase < 0.0f) {
+ phase = phase - (long)(phase);
+ }
+ 
+ prev = input;
+ 
+ return phase;
+ }
+ 
+ 
+ 
+ inline float process_lock(float input, float ratio) {
+ // did multiplier change?
+ if (ratio != mult && std::isfinite(ratio) && ratio != 0) {
+ mult = ratio;
+ invmult = 1.0f / mult;
+ wantlock = 1;
+ }
+ float diff = input - prev;
+ 
+ if (diff < -0.5f) {
+ diff += 1.0f;
+ } else if (diff > 0.5f) {
+ diff -= 1.0f;
+ }
+ 
+ if (wantlock) {
+ // recalculate phase
+ phase = (input - QUANT(input, quant)) * invmult
+ + QUANT(input, quant * mult);
+ diff = 0;
+ wantlock = 0;
+ } else {
+ // diff is always between -0.5 and 0.5
+ phase += diff * invmult;
+ }
+ 
+ if (phase > 1.0f || phase < 0.0f) {
+ phase = phase - (long)(phase);
+ }
+ 
+ prev = input;
+ 
+ return phase;
+ }
+ 
+ inline float process_off(float input, float ratio) {
+ // did multiplier change?
+ if (ratio != mult && std::isfinite(ratio) && ratio != 0.0) {
+ mult = ratio;
+ invmult = 1.0 / mult;
+ wantlock = 1;
+ }
+ float diff = input - prev;
+ 
+ if (diff < float(-0.5)) {
+ diff += float(1);
+ } else if (diff > float(0.5)) {
+ diff -= float(1);
+ }
+ 
+ phase += diff * invmult;
+ 
+ if (phase > float(1.) || phase < float(-0.)) {
+ phase = phase - (long)(phase);
+ }
+ 
+ prev = input;
+ 
+ return phase;
+ } */
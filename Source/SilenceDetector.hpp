@@ -0,0 +1,110 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include <JuceHeader.h>
+
+// Finds out when the whole processor can stop: the input has to stay below the threshold (-100 dB),
+// and what it left behind has to have rung out, after that the output is silence as well.
+// The tail is the longest it can ring, the output shows when it's done sooner:
+// once the last input had time to come out, an output that stays below the threshold means the rest of the tail does too.
+// Anything over the threshold brings it back right away, in the same block
+class SilenceDetector
+{
+public:
+    
+    static constexpr float threshold = 1e-5f;
+    
+    void prepare(int new_tail_samples, int new_latency) {
+        tail_samples = new_tail_samples;
+        latency = new_latency;
+        reset();
+    }
+    
+    // The output only follows the input after the latency, so that's where its silence starts counting
+    void set_latency(int new_latency) {
+        latency = new_latency;
+    }
+    
+    void reset() {
+        silent_samples = 0;
+        quiet_samples = 0;
+        idle = false;
+        resumed = false;
+    }
+    
+    // Input side, returns false when the block can be skipped
+    bool process(const AudioBuffer<float>& buffer, int num_channels) {
+        int num_samples = buffer.getNumSamples();
+        bool silent = is_silent(buffer, num_channels);
+        
+        resumed = idle && !silent;
+        
+        if(!silent) {
+            silent_samples = 0;
+            idle = false;
+        }
+        else if(!idle) {
+            // The block that completes the tail still has to run
+            bool rung_out = silent_samples > tail_samples;
+            bool quiet_since = silent_samples > latency && quiet_samples >= silent_samples - latency;
+            
+            idle = rung_out || quiet_since;
+            silent_samples += num_samples;
+        }
+        
+        return !idle;
+    }
+    
+    // Output side, call with the processed block
+    void process_output(const AudioBuffer<float>& buffer, int num_channels) {
+        // Past the whole tail it doesn't matter how much longer it's been quiet
+        quiet_samples = is_silent(buffer, num_channels) ? std::min(quiet_samples + buffer.getNumSamples(), tail_samples) : 0;
+    }
+    
+    // True for the first block after a silent stretch, the DSP only holds what was below the threshold then
+    bool has_resumed() const { return resumed; }
+    
+private:
+    
+    static bool is_silent(const AudioBuffer<float>& buffer, int num_channels) {
+        bool silent = true;
+        for(int ch = 0; ch < std::min(num_channels, buffer.getNumChannels()) && silent; ch++) {
+            silent = buffer.getMagnitude(ch, 0, buffer.getNumSamples()) < threshold;
+        }
+        
+        return silent;
+    }
+    
+    int tail_samples = 0;
+    int latency = 0;
+    
+    // Input samples below the threshold, and output samples below it, in a row
+    int silent_samples = 0;
+    int quiet_samples = 0;
+    
+    bool idle = false;
+    bool resumed = false;
+};
@@ -0,0 +1,73 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include <JuceHeader.h>
+
+// Runs the work for a block of input in slices, spread evenly over the samples of the block after it
+// Once x% of the next block has come in, x% of the slices have run, so each callback gets a share
+// of the work that fits its length instead of one callback getting all of it.
+// Whatever is left runs when the next block is complete, the caller hands out the result from then on,
+// which delays the output by one more block.
+class SliceExecutor
+{
+public:
+    
+    void set_work(std::function<void(int)> new_run_slice) {
+        run_slice = std::move(new_run_slice);
+    }
+    
+    // Starts over with the work for a block that was just completed
+    void start(int new_num_slices) {
+        num_slices = new_num_slices;
+        slices_done = 0;
+    }
+    
+    // Runs the slices that are due once progress out of block_size samples of the next block have come in
+    void advance(int progress, int block_size) {
+        run_until((int)(((int64)num_slices * progress + block_size - 1) / block_size));
+    }
+    
+    // Runs everything that is left
+    void finish() {
+        run_until(num_slices);
+    }
+    
+    // Drops everything that is left
+    void cancel() {
+        slices_done = num_slices;
+    }
+    
+private:
+    
+    void run_until(int target) {
+        while(slices_done < target) {
+            run_slice(slices_done++);
+        }
+    }
+    
+    std::function<void(int)> run_slice;
+    int num_slices = 0, slices_done = 0;
+};
@@ -0,0 +1,92 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// Single producer, single consumer triple buffer
+// The writer always has a buffer of its own and publishing is one atomic exchange, so the audio thread never waits
+// The reader only ever sees complete frames, intermediate frames it was too slow for are dropped
+template<typename Type>
+class TripleBuffer
+{
+public:
+    
+    // Writer side (audio thread)
+    Type& get_write_buffer() { return buffers[write_index]; }
+    
+    void publish() {
+        int previous = middle.exchange(write_index | dirty_flag, std::memory_order_acq_rel);
+        write_index = previous & index_mask;
+    }
+    
+    // Reader side (message thread), returns true when there's a new frame
+    bool fetch() {
+        if(!(middle.load(std::memory_order_relaxed) & dirty_flag)) return false;
+        
+        int previous = middle.exchange(read_index, std::memory_order_acq_rel);
+        read_index = previous & index_mask;
+        return true;
+    }
+    
+    const Type& get_read_buffer() const { return buffers[read_index]; }
+    
+    // Lets the writer leave out what's expensive to fill in while nobody reads the frames
+    void set_reader_active(bool active) { reader_active.store(active, std::memory_order_relaxed); }
+    bool has_reader() const { return reader_active.load(std::memory_order_relaxed); }
+    
+private:
+    
+    static constexpr int index_mask = 3;
+    static constexpr int dirty_flag = 4;
+    
+    std::array<Type, 3> buffers {};
+    
+    int write_index = 0, read_index = 1;
+    std::atomic<int> middle { 2 };
+    std::atomic<bool> reader_active { false };
+};
+
+// What the engine is doing, published once per processBlock
+struct TelemetryFrame
+{
+    static constexpr int max_bands = 96;
+    
+    // Envelope level and mean energy of each chroma filter band over the last analysis block
+    std::array<float, max_bands> band_levels {};
+    std::array<float, max_bands> chroma_energies {};
+    int num_bands = 0;
+    
+    // Chromagram of the input, C first
+    std::array<float, 12> pitch_classes {};
+    
+    // Tracked pitch in Hz, 0 when there is none, and how sure the tracker is of it from 0 to 1
+    float pitch = 0.0f;
+    float pitch_confidence = 0.0f;
+    
+    // Time spent in processBlock relative to the block duration
+    float cpu_load = 0.0f;
+};
@@ -0,0 +1,98 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+#include <JuceHeader.h>
+
+// Host transport for the current block, read from the playhead once per processBlock
+// Everything that follows the tempo reads this instead of polling the playhead itself
+// Fits in one cache line, so the readers don't touch anything else
+struct alignas(64) TransportState
+{
+    double bpm = 120.0;
+    
+    // Song position in quarter notes at the first sample of the block, and how far it moves per sample
+    double ppq_position = 0.0;
+    double ppq_per_sample = 0.0;
+    
+    double sample_rate = 44100.0;
+    
+    int num_samples = 0;
+    
+    // True when the host gave us a tempo
+    bool valid = false;
+    bool is_playing = false;
+    
+    // Set when the position didn't follow on from the previous block: transport started, looped or was moved
+    bool jumped = true;
+    
+    void update(AudioPlayHead* playhead, double new_sample_rate, int block_size) {
+        sample_rate = new_sample_rate;
+        
+        AudioPlayHead::CurrentPositionInfo position_info;
+        bool has_position = playhead && playhead->getCurrentPosition(position_info) && position_info.bpm > 0.0;
+        
+        // Where we expected to be, from the previous block
+        double expected = ppq_position + ppq_per_sample * num_samples;
+        bool was_playing = is_playing;
+        
+        num_samples = block_size;
+        valid = has_position;
+        
+        if(!has_position) {
+            is_playing = false;
+            jumped = true;
+            ppq_per_sample = bpm / (60.0 * sample_rate);
+            ppq_position = expected;
+            return;
+        }
+        
+        bpm = position_info.bpm;
+        is_playing = position_info.isPlaying;
+        ppq_per_sample = bpm / (60.0 * sample_rate);
+        ppq_position = position_info.ppqPosition;
+        
+        // Allow a sample of rounding from hosts that report the position as samples
+        jumped = is_playing != was_playing || std::abs(ppq_position - expected) > 2.0 * ppq_per_sample;
+    }
+    
+    double get_ppq(int sample) const { return ppq_position + ppq_per_sample * sample; }
+    
+    // Ramp from 0 to 1 once every 1 / cycles_per_beat quarter notes, locked to the song position
+    // This is the input Rate expects, so Rate can turn it into tempo-locked ramps at any ratio
+    void render_phasor(float* output, double cycles_per_beat, int length) const {
+        double phase = get_ppq(0) * cycles_per_beat;
+        phase -= std::floor(phase);
+        
+        double increment = ppq_per_sample * cycles_per_beat;
+        
+        for(int n = 0; n < length; n++) {
+            output[n] = (float)phase;
+            phase += increment;
+            phase -= phase >= 1.0 ? 1.0 : 0.0;
+        }
+    }
+};
+
+static_assert(sizeof(TransportState) == 64, "TransportState should stay within one cache line");
@@ -0,0 +1,82 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#include "WindowCache.hpp"
+
+#include <map>
+
+const std::vector<float>& WindowCache::get(Type type, int size, float kaiser_beta) {
+    static CriticalSection lock;
+    static std::map<std::tuple<int, int, float>, std::unique_ptr<std::vector<float>>> windows;
+    
+    jassert(size > 0);
+    
+    const ScopedLock scoped_lock(lock);
+    
+    auto& window = windows[{type, size, type == kaiser ? kaiser_beta : 0.0f}];
+    if(!window) window = std::make_unique<std::vector<float>>(calculate(type, size, kaiser_beta));
+    
+    return *window;
+}
+
+std::vector<float> WindowCache::calculate(Type type, int size, float kaiser_beta) {
+    auto bessel_i0 = [](double x) {
+        double sum = 1.0, term = 1.0;
+        for(int k = 1; term > 1e-12 * sum; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    };
+    
+    const double two_pi = MathConstants<double>::twoPi;
+    
+    std::vector<float> window(size);
+    
+    for(int n = 0; n < size; n++) {
+        double progress = (double)n / size;
+        
+        switch(type) {
+            case hann:
+                window[n] = 0.5 - 0.5 * std::cos(two_pi * progress);
+                break;
+                
+            case hamming:
+                window[n] = 0.54 - 0.46 * std::cos(two_pi * progress);
+                break;
+                
+            case blackman_harris:
+                window[n] = 0.35875 - 0.48829 * std::cos(two_pi * progress) + 0.14128 * std::cos(2.0 * two_pi * progress) - 0.01168 * std::cos(3.0 * two_pi * progress);
+                break;
+                
+            case kaiser: {
+                double ratio = 2.0 * progress - 1.0;
+                window[n] = bessel_i0(kaiser_beta * std::sqrt(1.0 - ratio * ratio)) / bessel_i0(kaiser_beta);
+                break;
+            }
+        }
+    }
+    
+    return window;
+}
@@ -0,0 +1,65 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+#pragma once
+
+#include <JuceHeader.h>
+
+// Window tables, shared by everything in the process
+//
+// Each type and size is computed the first time it's asked for and stays allocated until the process ends.
+// get() takes a lock, so call it when preparing and keep the reference: windowing is then a vectorised multiply.
+// All windows are periodic, window[n] = w(n / size): a Hann window at half overlap adds up to exactly one,
+// and it sums to size / 2, so a sine's amplitude through it is easy to recover.
+class WindowCache
+{
+public:
+    
+    enum Type
+    {
+        hann,
+        hamming,
+        blackman_harris,
+        kaiser
+    };
+    
+    // Side lobes around -70 dB, about as low as Blackman-Harris with a narrower main lobe
+    static constexpr float default_kaiser_beta = 9.0f;
+    
+    // The beta is only used for Kaiser windows
+    static const std::vector<float>& get(Type type, int size, float kaiser_beta = default_kaiser_beta);
+    
+    // Multiplies the first window.size() samples by the window
+    static void apply(const std::vector<float>& window, float* samples) {
+        FloatVectorOperations::multiply(samples, window.data(), (int)window.size());
+    }
+    
+    static void apply(const std::vector<float>& window, const float* source, float* destination) {
+        FloatVectorOperations::multiply(destination, source, window.data(), (int)window.size());
+    }
+    
+private:
+    
+    static std::vector<float> calculate(Type type, int size, float kaiser_beta);
+};
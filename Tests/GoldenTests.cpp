@@ -0,0 +1,626 @@
+/**********************************************************************
+*          Copyright (c) 2020, Hogeschool voor de Kunsten Utrecht
+*                      Utrecht, the Netherlands
+*                          All rights reserved
+***********************************************************************
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.
+*  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************
+*
+*  Author             : Timothy Schoen
+*  E-mail             : timschoen123@gmail.com
+*
+**********************************************************************/
+
+// Golden output tests
+//
+// Renders a fixed set of test signals through the filter banks and envelope followers,
+// and compares the result with recordings in the golden directory, each component with its own tolerance.
+// The recordings in Tests/Golden come from the sources as they were before the SIMD kernels went in,
+// so they hold the current code to what the plugin did before, not to its own output.
+//
+// The live waveshaper and the processor presets changed on purpose since then, they have no reference to compare with.
+// Those are checked for finite output, for rendering the same twice, and for the generic kernels agreeing with the dispatched ones.
+// The real FFT plans are checked against kiss_fftr directly, they need no recordings either.
+//
+// ZirconGoldenTests <golden directory> [--update]
+//
+// --update records the goldens instead of comparing, only use it after an intended change to one of the golden components.
+// Set ZIRCON_FORCE_SCALAR=1 to run the same comparison on the generic kernels.
+
+#include <JuceHeader.h>
+
+#include "../Source/PluginProcessor.hpp"
+#include "../Source/MonoDistortion.hpp"
+#include "../Source/ChromaFilter.hpp"
+#include "../Source/Filterbanks/GammatoneFilterBank.hpp"
+#include "../Source/Filterbanks/ResonBands.hpp"
+#include "../Source/HilbertEnvelope.hpp"
+#include "../Source/RMSEnvelope.hpp"
+#include "../Source/FFTPlan.hpp"
+#include "../Source/Kernels/Kernels.hpp"
+#include "../Source/PitchDetection/tools/AudioFile.h"
+#include "../Source/PitchDetection/tools/kiss_fftr.h"
+
+#include <iostream>
+#include <random>
+
+namespace {
+
+constexpr double sample_rate = 44100.0;
+constexpr int host_block_size = 512;
+constexpr int signal_length = 1 << 14;
+
+// Band outputs are stored one band after the other, keeping every subsample-th sample so the files stay small
+constexpr int subsample = 16;
+
+// Channels of rendered output, one or two so they fit in a WAV file
+using Render = std::vector<std::vector<float>>;
+
+struct Signal
+{
+    String name;
+    std::vector<float> samples;
+};
+
+std::vector<Signal> make_signals() {
+    std::vector<Signal> signals;
+    
+    auto add = [&signals](const String& name, std::function<float(int)> generate) {
+        Signal signal { name, std::vector<float>(signal_length) };
+        for(int n = 0; n < signal_length; n++) signal.samples[n] = generate(n);
+        signals.push_back(std::move(signal));
+    };
+    
+    add("sine", [](int n) {
+        return 0.5f * (float)std::sin(MathConstants<double>::twoPi * 220.0 * n / sample_rate);
+    });
+    
+    // Exponential sweep from 30 Hz to 16 kHz over the whole signal
+    add("sweep", [](int n) {
+        double duration = signal_length / sample_rate;
+        double ratio = std::log(16000.0 / 30.0);
+        double t = n / sample_rate;
+        
+        return 0.5f * (float)std::sin(MathConstants<double>::twoPi * 30.0 * duration / ratio * (std::exp(t / duration * ratio) - 1.0));
+    });
+    
+    // Fixed seed, and our own mapping to floats, so every standard library gives the same noise
+    std::minstd_rand random(1);
+    add("noise", [&random](int) {
+        return 0.25f * ((float)(random() - std::minstd_rand::min()) / (float)(std::minstd_rand::max() - std::minstd_rand::min()) * 2.0f - 1.0f);
+    });
+    
+    // A click with a decaying 1 kHz burst every 8192 samples
+    add("transients", [](int n) {
+        int position = n % 8192;
+        if(position == 0) return 0.9f;
+        
+        return 0.8f * std::exp(-position / 400.0f) * (float)std::sin(MathConstants<double>::twoPi * 1000.0 * position / sample_rate);
+    });
+    
+    return signals;
+}
+
+// The right channel is the left one, quieter and a few samples late, so the stereo paths don't see the same signal
+float right_channel(const Signal& signal, int n) {
+    return n >= 7 ? 0.8f * signal.samples[n - 7] : 0.0f;
+}
+
+// Band outputs, one band after the other, subsampled
+Render flatten_bands(const std::vector<std::vector<float>>& bands) {
+    Render result(1);
+    
+    for(auto& band : bands) {
+        for(size_t n = 0; n < band.size(); n += subsample) result[0].push_back(band[n]);
+    }
+    
+    return result;
+}
+
+Render render_filterbank(Filterbank& filterbank, const Signal& signal) {
+    int num_bands = filterbank.get_num_filters();
+    
+    std::vector<AudioBuffer<float>> band_buffers(num_bands, AudioBuffer<float>(1, host_block_size));
+    std::vector<AudioBlock<float>> band_blocks;
+    for(auto& buffer : band_buffers) band_blocks.emplace_back(buffer);
+    
+    std::vector<std::vector<float>> bands(num_bands, std::vector<float>(signal_length));
+    
+    for(int start = 0; start < signal_length; start += host_block_size) {
+        int num_samples = std::min(host_block_size, signal_length - start);
+        
+        float* input = const_cast<float*>(signal.samples.data()) + start;
+        filterbank.process(AudioBlock<float>(&input, 1, num_samples), band_blocks);
+        
+        for(int b = 0; b < num_bands; b++) {
+            std::copy(band_blocks[b].getChannelPointer(0), band_blocks[b].getChannelPointer(0) + num_samples, bands[b].begin() + start);
+        }
+    }
+    
+    return flatten_bands(bands);
+}
+
+Render render_gammatone(const Signal& signal) {
+    ProcessSpec spec { sample_rate, (juce::uint32)host_block_size, 1 };
+    
+    GammatoneFilterBank filterbank(spec);
+    filterbank.init_with_overlap(60.0f, 10000.0f, -0.9f);
+    
+    return render_filterbank(filterbank, signal);
+}
+
+Render render_reson(const Signal& signal) {
+    ProcessSpec spec { sample_rate, (juce::uint32)host_block_size, 1 };
+    
+    ResonBands filterbank(spec);
+    filterbank.create_bands(12, {60.0f, 10000.0f});
+    
+    return render_filterbank(filterbank, signal);
+}
+
+// The envelope of each reson band, like the band path of the processor uses them
+Render render_envelope(const Signal& signal, bool rms) {
+    ProcessSpec spec { sample_rate, (juce::uint32)host_block_size, 1 };
+    
+    ResonBands filterbank(spec);
+    filterbank.create_bands(12, {60.0f, 10000.0f});
+    int num_bands = filterbank.get_num_filters();
+    
+    std::unique_ptr<EnvelopeFollower> envelope_follower;
+    if(rms) envelope_follower.reset(new RMSEnvelope(spec, num_bands, 1));
+    else    envelope_follower.reset(new HilbertEnvelope(spec, num_bands, 1));
+    
+    std::vector<AudioBuffer<float>> buffers(4 * num_bands, AudioBuffer<float>(1, host_block_size));
+    std::vector<AudioBlock<float>> band_blocks, instant_amp, envelope, phase;
+    for(int b = 0; b < num_bands; b++) {
+        band_blocks.emplace_back(buffers[b]);
+        instant_amp.emplace_back(buffers[num_bands + b]);
+        envelope.emplace_back(buffers[2 * num_bands + b]);
+        phase.emplace_back(buffers[3 * num_bands + b]);
+    }
+    
+    std::vector<std::vector<float>> bands(num_bands, std::vector<float>(signal_length));
+    
+    for(int start = 0; start < signal_length; start += host_block_size) {
+        int num_samples = std::min(host_block_size, signal_length - start);
+        
+        float* input = const_cast<float*>(signal.samples.data()) + start;
+        filterbank.process(AudioBlock<float>(&input, 1, num_samples), band_blocks);
+        envelope_follower->process(band_blocks, instant_amp, envelope, phase, num_samples);
+        
+        for(int b = 0; b < num_bands; b++) {
+            std::copy(envelope[b].getChannelPointer(0), envelope[b].getChannelPointer(0) + num_samples, bands[b].begin() + start);
+        }
+    }
+    
+    return flatten_bands(bands);
+}
+
+Render render_chroma_filter(const Signal& signal) {
+    auto chroma_filter = std::make_unique<ChromaFilter>();
+    chroma_filter->prepare(1);
+    
+    int num_bands = chroma_filter->get_num_bands();
+    std::vector<std::vector<float>> bands(num_bands, std::vector<float>(signal_length));
+    
+    for(int start = 0; start < signal_length; start += ChromaFilter::block_size) {
+        int num_samples = std::min(ChromaFilter::block_size, signal_length - start);
+        
+        const float* input = signal.samples.data() + start;
+        auto& output = chroma_filter->process(&input, num_samples);
+        
+        for(int b = 0; b < num_bands; b++) {
+            std::copy(output[0][b].begin(), output[0][b].begin() + num_samples, bands[b].begin() + start);
+        }
+    }
+    
+    return flatten_bands(bands);
+}
+
+// Two voices, the second one with a stereo LFO
+Render render_distortion(const Signal& signal, bool poly) {
+    auto distortion = std::make_unique<MonoDistortion>();
+    distortion->prepare(2);
+    
+    distortion->receive_message("Kind", poly, 0);
+    
+    distortion->add_voice();
+    distortion->receive_message("X", 0.25f, 0);
+    distortion->receive_message("Y", 0.3f, 0);
+    
+    distortion->add_voice();
+    distortion->receive_message("ModShape", 1, 1);
+    distortion->receive_message("ModDepth", 0.5f, 1);
+    distortion->receive_message("ModRate", 3.0f, 1);
+    distortion->receive_message("ModSettings", 2, 1);
+    distortion->receive_message("X", 0.6f, 1);
+    distortion->receive_message("Y", 0.6f, 1);
+    
+    distortion->reset();
+    
+    Render result(2, std::vector<float>(signal_length));
+    TransportState transport;
+    
+    for(int start = 0; start < signal_length; start += host_block_size) {
+        int num_samples = std::min(host_block_size, signal_length - start);
+        
+        for(int n = 0; n < num_samples; n++) {
+            result[0][start + n] = signal.samples[start + n];
+            result[1][start + n] = right_channel(signal, start + n);
+        }
+        
+        std::array<float*, 2> channels = { result[0].data() + start, result[1].data() + start };
+        AudioBlock<float> block(channels.data(), 2, num_samples);
+        
+        distortion->process(block, transport);
+    }
+    
+    return result;
+}
+
+struct Preset
+{
+    String name;
+    NamedValueSet settings;
+    std::vector<NamedValueSet> sliders;
+};
+
+const std::vector<Preset>& get_presets() {
+    static const std::vector<Preset> presets = []() {
+        auto slider = [](bool poly, float x, float y) {
+            NamedValueSet values;
+            values.set("Kind", poly);
+            values.set("X", x);
+            values.set("Y", y);
+            return values;
+        };
+        
+        std::vector<Preset> result;
+        
+        result.push_back({ "poly", {}, { slider(true, 0.3f, 0.3f) } });
+        result.push_back({ "mono", {}, { slider(false, 0.3f, 0.3f) } });
+        
+        auto modulated = slider(true, 0.2f, 0.2f);
+        modulated.set("ModShape", 1);
+        modulated.set("ModDepth", 0.5f);
+        modulated.set("ModRate", 4.0f);
+        modulated.set("ModSettings", 2);
+        
+        NamedValueSet mid_side;
+        mid_side.set("MidSide", true);
+        result.push_back({ "poly_mid_side_lfo", mid_side, { modulated, slider(true, 0.6f, 0.5f) } });
+        
+        NamedValueSet selection;
+        selection.set("ChromaSelection", 3);
+        selection.set("LinkedAnalysis", false);
+        result.push_back({ "poly_chroma_selection", selection, { slider(true, 0.4f, 0.3f) } });
+        
+        return result;
+    }();
+    
+    return presets;
+}
+
+Render render_preset(const Preset& preset, const Signal& signal) {
+    auto processor = std::make_unique<ZirconAudioProcessor>();
+    
+    for(auto& setting : preset.settings) {
+        processor->main_tree.setProperty(setting.name, setting.value, nullptr);
+    }
+    
+    auto pad_tree = processor->main_tree.getOrCreateChildWithName("XYPad", nullptr);
+    
+    for(auto& values : preset.sliders) {
+        ValueTree slider_tree("XYSlider");
+        pad_tree.appendChild(slider_tree, nullptr);
+        
+        // Kind first, switching modes starts the engine over
+        slider_tree.setProperty("Kind", values["Kind"], nullptr);
+        for(auto& value : values) {
+            if(value.name != Identifier("Kind")) slider_tree.setProperty(value.name, value.value, nullptr);
+        }
+    }
+    
+    processor->setPlayConfigDetails(2, 2, sample_rate, host_block_size);
+    processor->prepareToPlay(sample_rate, host_block_size);
+    
+    Render result(2, std::vector<float>(signal_length));
+    AudioBuffer<float> buffer(2, host_block_size);
+    MidiBuffer midi;
+    
+    for(int start = 0; start < signal_length; start += host_block_size) {
+        int num_samples = std::min(host_block_size, signal_length - start);
+        buffer.setSize(2, num_samples, false, false, true);
+        
+        for(int n = 0; n < num_samples; n++) {
+            buffer.setSample(0, n, signal.samples[start + n]);
+            buffer.setSample(1, n, right_channel(signal, start + n));
+        }
+        
+        processor->processBlock(buffer, midi);
+        
+        for(int ch = 0; ch < 2; ch++) {
+            std::copy(buffer.getReadPointer(ch), buffer.getReadPointer(ch) + num_samples, result[ch].begin() + start);
+        }
+    }
+    
+    processor->releaseResources();
+    return result;
+}
+
+// What ends up in the file: scaled by the gain of the case and clipped to the range of 24 bit samples
+float to_stored(float sample, float gain) {
+    return std::clamp(sample * gain, -1.0f, 8388607.0f / 8388608.0f);
+}
+
+struct Case
+{
+    String name;
+    
+    // Brings the output into the range of a WAV file
+    float gain;
+    
+    // Largest difference with the golden that still passes, after the gain
+    // Filters and envelopes only differ by rounding between kernels and the order of the operations
+    float tolerance;
+    
+    std::function<Render(const Signal&)> render;
+};
+
+std::vector<Case> get_cases() {
+    return {
+        { "GammatoneFilterBank", 0.5f, 1e-4f, render_gammatone },
+        { "ResonBands", 0.5f, 1e-4f, render_reson },
+        { "HilbertEnvelope", 1.0f, 1e-4f, [](const Signal& signal) { return render_envelope(signal, false); } },
+        { "RMSEnvelope", 1.0f, 1e-4f, [](const Signal& signal) { return render_envelope(signal, true); } },
+        { "ChromaFilter", 0.5f, 1e-4f, render_chroma_filter },
+    };
+}
+
+// Components without a golden
+struct Check
+{
+    String name;
+    
+    // Largest difference between the generic and the dispatched kernels
+    // The shapers turn rounding into a little more than the filters do,
+    // and a pitch tracker that lands on another period changes mono mode a lot more than that
+    float tolerance;
+    
+    // The processor picks the kernels itself in prepareToPlay, ZIRCON_FORCE_SCALAR is the only way to change them there
+    bool compare_kernels;
+    
+    std::function<Render(const Signal&)> render;
+};
+
+std::vector<Check> get_checks() {
+    std::vector<Check> checks = {
+        { "MonoDistortion_poly", 1e-3f, true, [](const Signal& signal) { return render_distortion(signal, true); } },
+        { "MonoDistortion_mono", 1e-2f, true, [](const Signal& signal) { return render_distortion(signal, false); } },
+    };
+    
+    for(auto& preset : get_presets()) {
+        checks.push_back({ "Preset_" + preset.name, 0.0f, false, [&preset](const Signal& signal) { return render_preset(preset, signal); } });
+    }
+    
+    return checks;
+}
+
+// Largest difference between two renders, a NaN, an infinity or a size mismatch counts as the largest float
+float compare_renders(const Render& a, const Render& b) {
+    if(a.size() != b.size()) return std::numeric_limits<float>::max();
+    
+    float difference = 0.0f;
+    for(size_t ch = 0; ch < a.size(); ch++) {
+        if(a[ch].size() != b[ch].size()) return std::numeric_limits<float>::max();
+        
+        for(size_t n = 0; n < a[ch].size(); n++) {
+            if(!std::isfinite(a[ch][n]) || !std::isfinite(b[ch][n])) return std::numeric_limits<float>::max();
+            difference = std::max(difference, std::abs(a[ch][n] - b[ch][n]));
+        }
+    }
+    
+    return difference;
+}
+
+// Every render starts from a fresh instance, so a second one has to match the first to the bit
+bool run_check(const Check& check, const Signal& signal) {
+    auto name = check.name + " " + signal.name;
+    
+    auto first = check.render(signal);
+    auto second = check.render(signal);
+    
+    float repeat_difference = compare_renders(first, second);
+    if(repeat_difference != 0.0f) {
+        std::cout << "FAIL " << name << ": not finite, or a second render is off by " << repeat_difference << std::endl;
+        return false;
+    }
+    
+    if(!check.compare_kernels) {
+        std::cout << "PASS " << name << ": finite and repeatable" << std::endl;
+        return true;
+    }
+    
+    Kernels::select(true);
+    auto generic = check.render(signal);
+    Kernels::select();
+    
+    float kernel_difference = compare_renders(first, generic);
+    if(kernel_difference > check.tolerance) {
+        std::cout << "FAIL " << name << ": generic kernels off by " << kernel_difference << ", tolerance " << check.tolerance << std::endl;
+        return false;
+    }
+    
+    std::cout << "PASS " << name << ": finite and repeatable, generic kernels off by " << kernel_difference << std::endl;
+    return true;
+}
+
+bool save_golden(const File& file, const Render& render, float gain) {
+    AudioFile<float> audio_file;
+    audio_file.setBitDepth(24);
+    audio_file.setSampleRate((uint32_t)sample_rate);
+    audio_file.setAudioBufferSize((int)render.size(), (int)render[0].size());
+    
+    for(size_t ch = 0; ch < render.size(); ch++) {
+        for(size_t n = 0; n < render[ch].size(); n++) audio_file.samples[ch][n] = to_stored(render[ch][n], gain);
+    }
+    
+    return audio_file.save(file.getFullPathName().toStdString());
+}
+
+// Returns the largest difference, or a negative value when the golden is missing or doesn't match in size
+float compare_golden(const File& file, const Render& render, float gain) {
+    AudioFile<float> audio_file;
+    if(!file.existsAsFile() || !audio_file.load(file.getFullPathName().toStdString())) return -1.0f;
+    
+    if(audio_file.getNumChannels() != (int)render.size() || audio_file.getNumSamplesPerChannel() != (int)render[0].size()) return -1.0f;
+    
+    float difference = 0.0f;
+    for(size_t ch = 0; ch < render.size(); ch++) {
+        for(size_t n = 0; n < render[ch].size(); n++) {
+            float sample = to_stored(render[ch][n], gain);
+            
+            // A NaN never compares larger, count it as a failure
+            if(!std::isfinite(sample)) return std::numeric_limits<float>::max();
+            
+            difference = std::max(difference, std::abs(sample - audio_file.samples[ch][n]));
+        }
+    }
+    
+    return difference;
+}
+
+// Both directions of a real FFT plan against kiss_fftr, relative to the largest value
+// Power of two sizes run on JUCE's engine, other sizes on the kiss_fft path of FFTPlan
+bool check_fft(int size) {
+    std::minstd_rand random(size);
+    std::vector<float> input(size);
+    for(auto& sample : input) sample = (float)(random() - std::minstd_rand::min()) / (float)(std::minstd_rand::max() - std::minstd_rand::min()) * 2.0f - 1.0f;
+    
+    auto& forward = FFTPlan::get(size, FFTPlan::forward);
+    auto& inverse = FFTPlan::get(size, FFTPlan::inverse);
+    
+    std::vector<FFTPlan::Complex> spectrum(forward.get_num_bins()), scratch(forward.get_scratch_size());
+    std::vector<float> output(size);
+    
+    forward.perform(input.data(), spectrum.data(), scratch.data());
+    inverse.perform(spectrum.data(), output.data(), scratch.data());
+    
+    std::vector<kiss_fft_cpx> reference_spectrum(size / 2 + 1);
+    std::vector<float> reference_output(size);
+    
+    auto* forward_config = kiss_fftr_alloc(size, 0, nullptr, nullptr);
+    auto* inverse_config = kiss_fftr_alloc(size, 1, nullptr, nullptr);
+    
+    kiss_fftr(forward_config, input.data(), reference_spectrum.data());
+    kiss_fftri(inverse_config, reference_spectrum.data(), reference_output.data());
+    
+    kiss_fftr_free(forward_config);
+    kiss_fftr_free(inverse_config);
+    
+    float peak = 0.0f, difference = 0.0f;
+    for(int k = 0; k <= size / 2; k++) {
+        FFTPlan::Complex reference(reference_spectrum[k].r, reference_spectrum[k].i);
+        peak = std::max(peak, std::abs(reference));
+        difference = std::max(difference, std::abs(spectrum[k] - reference));
+    }
+    
+    float output_peak = 0.0f, output_difference = 0.0f;
+    for(int n = 0; n < size; n++) {
+        output_peak = std::max(output_peak, std::abs(reference_output[n]));
+        output_difference = std::max(output_difference, std::abs(output[n] - reference_output[n]));
+    }
+    
+    // Float rounding in a different order, a few ulps of the peak
+    constexpr float tolerance = 1e-5f;
+    bool passed = difference <= tolerance * peak && output_difference <= tolerance * output_peak;
+    
+    std::cout << (passed ? "PASS " : "FAIL ") << "FFTPlan " << size << ": forward " << difference / peak << ", inverse " << output_difference / output_peak << " of the peak" << std::endl;
+    return passed;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juce_initialiser;
+    
+    if(argc < 2) {
+        std::cout << "Usage: ZirconGoldenTests <golden directory> [--update]" << std::endl;
+        return 2;
+    }
+    
+    auto golden_directory = File::getCurrentWorkingDirectory().getChildFile(argv[1]);
+    bool update = argc > 2 && String(argv[2]) == "--update";
+    
+    if(update && !golden_directory.createDirectory()) {
+        std::cout << "Can't create " << golden_directory.getFullPathName() << std::endl;
+        return 2;
+    }
+    
+    Kernels::select();
+    std::cout << "Kernels: " << Kernels::get_level_name() << std::endl;
+    
+    int num_failures = 0;
+    
+    for(int size : { 64, 2048, 6000, 8192 }) {
+        if(!check_fft(size)) num_failures++;
+    }
+    
+    auto signals = make_signals();
+    
+    for(auto& test_case : get_cases()) {
+        for(auto& signal : signals) {
+            auto render = test_case.render(signal);
+            auto file = golden_directory.getChildFile(test_case.name + "_" + signal.name + ".wav");
+            auto name = test_case.name + " " + signal.name;
+            
+            if(update) {
+                if(!save_golden(file, render, test_case.gain)) {
+                    std::cout << "FAIL " << name << ": can't write " << file.getFullPathName() << std::endl;
+                    num_failures++;
+                }
+                continue;
+            }
+            
+            float difference = compare_golden(file, render, test_case.gain);
+            
+            if(difference < 0.0f) {
+                std::cout << "FAIL " << name << ": no golden at " << file.getFullPathName() << ", record them with --update" << std::endl;
+                num_failures++;
+            }
+            // One step of the 24 bit files on top, the golden is quantised
+            else if(difference > test_case.tolerance + 1.0f / 8388608.0f) {
+                std::cout << "FAIL " << name << ": off by " << difference << ", tolerance " << test_case.tolerance << std::endl;
+                num_failures++;
+            }
+            else {
+                std::cout << "PASS " << name << ": off by " << difference << std::endl;
+            }
+        }
+    }
+    
+    // Nothing to record for these
+    if(!update) {
+        for(auto& check : get_checks()) {
+            for(auto& signal : signals) {
+                if(!run_check(check, signal)) num_failures++;
+            }
+        }
+    }
+    
+    std::cout << (num_failures == 0 ? "All passed" : String(num_failures) + " failed") << std::endl;
+    return num_failures == 0 ? 0 : 1;
+}